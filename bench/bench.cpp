@@ -0,0 +1,81 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "bench.h"
+
+// Include C++ STL headers
+#include <iomanip>
+#include <iterator>
+
+// Include project headers
+#include "stats.h"
+
+namespace mmix {
+	namespace bench {
+		uint64_t allocations(void) {
+			return stats::allocations.load(std::memory_order_relaxed);
+		}
+
+		Runner::Runner(double min_time, const std::string& filter) : 
+			min_time_{min_time}, filter_{filter} {
+			stats::counting.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Runner::~Runner() {
+			stats::counting.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void Runner::report(std::ostream& stream, bool json) const {
+			if (json) {
+				stream << "[" << std::endl;
+				for (auto it = results_.begin(); it != results_.end(); ++it) {
+					auto seconds = it->seconds / it->iterations;
+					stream << "  {\"name\": \"" << it->name << "\""
+						<< ", \"lines\": " << it->lines
+						<< ", \"iterations\": " << it->iterations
+						<< ", \"seconds\": " << seconds
+						<< ", \"lines_per_second\": " << it->lines / seconds
+						<< ", \"allocations_per_line\": " 
+						<< static_cast<double>(it->allocations) / (it->lines * it->iterations)
+						<< "}" << (std::next(it) == results_.end() ? "" : ",") << std::endl;
+				}
+				stream << "]" << std::endl;
+				return;
+			}
+
+			stream << std::left << std::setw(36) << "benchmark" << std::right 
+				<< std::setw(12) << "lines" 
+				<< std::setw(12) << "iterations" 
+				<< std::setw(14) << "ms/iteration" 
+				<< std::setw(16) << "lines/s" 
+				<< std::setw(14) << "allocs/line" << std::endl;
+			for (const auto& result : results_) {
+				auto seconds = result.seconds / result.iterations;
+				stream << std::left << std::setw(36) << result.name << std::right 
+					<< std::setw(12) << result.lines 
+					<< std::setw(12) << result.iterations 
+					<< std::setw(14) << std::fixed << std::setprecision(3) << seconds * 1000
+					<< std::setw(16) << std::setprecision(0) << result.lines / seconds
+					<< std::setw(14) << std::setprecision(3) 
+					<< static_cast<double>(result.allocations) / (result.lines * result.iterations) 
+					<< std::endl;
+			}
+		}
+	} // namespace bench
+} // namespace mmix
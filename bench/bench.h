@@ -0,0 +1,112 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+namespace mmix {
+	namespace bench {
+		/**
+		 * Get the number of allocations made by the process so far
+		 * @return the number of calls of operator new
+		 */
+		uint64_t allocations(void);
+
+		/**
+		 * The result of a benchmark
+		 */
+		struct Result {
+			std::string name;			// The name of the benchmark
+			uint64_t 	lines;			// The number of lines processed by an iteration
+			uint64_t 	iterations;		// The number of measured iterations
+			double 		seconds;		// The total measured time
+			uint64_t 	allocations;	// The total number of allocations in the measured time
+		};
+
+		/**
+		 * Runs benchmarks and collects their results. Every
+		 * benchmark is repeated until it runs for the minimal
+		 * time, the setup of an iteration isn't measured.
+		 */
+		class Runner {
+		protected:
+			static constexpr double min_seconds = 1e-9;		// The shortest measured time of a benchmark
+
+			std::vector<Result> results_;		// Results of the finished benchmarks
+			double 				min_time_;		// The minimal measured time of a benchmark
+			std::string 		filter_;		// Only the benchmarks containing it are run
+
+		public:
+			/**
+			 * Constructor
+			 * @param min_time the minimal measured time of a benchmark in seconds
+			 * @param filter only the benchmarks containing the string are run
+			 */
+			Runner(double min_time, const std::string& filter);
+
+			/**
+			 * Destructor
+			 */
+			~Runner();
+
+			/**
+			 * Run a benchmark
+			 * @param name the name of the benchmark
+			 * @param lines the number of lines processed by an iteration
+			 * @param setup creates the input of an iteration (not measured)
+			 * @param body the measured code, it gets the result of the setup
+			 */
+			template <typename Setup, typename Body>
+			void run(const std::string& name, uint64_t lines, Setup setup, Body body) {
+				if (name.find(filter_) == std::string::npos) return;
+
+				Result 						result{name, lines, 0, 0.0, 0};
+				std::chrono::duration<double> 	elapsed{0};
+				do {
+					auto input = setup();
+
+					auto allocated 	= allocations();
+					auto start 		= std::chrono::steady_clock::now();
+					body(input);
+					elapsed 			+= std::chrono::steady_clock::now() - start;
+					result.allocations 	+= allocations() - allocated;
+					++result.iterations;
+				} while (elapsed.count() < min_time_);
+
+				// A run below the resolution of the clock still gives finite rates
+				result.seconds = std::max(elapsed.count(), min_seconds);
+				results_.push_back(result);
+			}
+
+			/**
+			 * Write the results
+			 * @param stream the output stream
+			 * @param json write JSON instead of a table
+			 */
+			void report(std::ostream& stream, bool json) const;
+		};
+	} // namespace bench
+} // namespace mmix
@@ -0,0 +1,336 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Include Boost headers
+#include <boost/program_options.hpp>
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <filesystem>
+#include <random>
+#include <cstdlib>
+
+// Include system headers
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <process.h>
+#endif // _WIN32
+
+// Include project headers
+#include "bench.h"
+#include "application.h"
+#include "lexer.h"
+#include "keywords.h"
+#include "parser.h"
+#include "macroprocessor.h"
+#include "preprocessor.h"
+#include "compiler.h"
+#include "hex.h"
+#include "assembler.h"
+#include "constants.h"
+#include "generator.h"
+
+using mmix::bench::Runner;
+using mmix::parser::RawProgram;
+using mmix::parser::RawFile;
+
+namespace {
+	/**
+	 * Kinds of the generated programs
+	 */
+	enum Program {
+		MNEMONICS = 0,		// Plain instructions
+		LABELS,				// "IS" labels and their uses
+		DATA,				// Allocated data and its uses
+		MACROS,				// Expansions of the macros
+		MIXED,				// The default mix of the generator
+		BLOCKS				// Blocks moved to their uses
+	};
+
+	/**
+	 * Write a generated program into a file
+	 * @param directory the directory of the file
+	 * @param kind the kind of the program
+	 * @param lines the number of lines
+	 * @return the name of the file
+	 */
+	std::string write(const std::filesystem::path& directory, Program kind, uint64_t lines) {
+		mmix::generator::Options options;
+		options.lines 		= lines;
+		options.directory 	= (directory / ("program_" + std::to_string(kind) + "_" + 
+			std::to_string(lines))).string();
+
+		// Every kind except the mixed one has a single kind of lines
+		if (kind != Program::MIXED) options.mix = mmix::generator::Mix{
+			kind == Program::MNEMONICS, 
+			kind == Program::LABELS, 
+			kind == Program::DATA, 
+			kind == Program::MACROS, 
+			0, 
+			kind == Program::BLOCKS};
+
+		return mmix::Generator(options).write().front();
+	}
+
+	/**
+	 * Map the file as a single-file program
+	 * @param filename the file to read
+	 * @return the program
+	 */
+	std::shared_ptr<RawProgram> read(const std::string& filename) {
+		auto program = std::make_shared<RawProgram>();
+		program->insert(std::make_pair(filename, std::make_shared<RawFile>(filename)));
+		return program;
+	}
+
+	/**
+	 * The state of the program after some stages
+	 */
+	struct Stages {
+		std::shared_ptr<mmix::Arena> 						arena{std::make_shared<mmix::Arena>()};
+		std::shared_ptr<mmix::SymbolTable> 					symbols{std::make_shared<mmix::SymbolTable>()};
+		std::shared_ptr<mmix::parser::ParsedProgram> 		parsed;
+		std::shared_ptr<mmix::macroprocessor::MacroprocessedProgram> 	macroprocessed;
+		std::shared_ptr<mmix::preprocessor::PreprocessedProgram> 		preprocessed;
+	};
+
+	/**
+	 * Run the stages before the measured one
+	 * @param raw the program
+	 * @param count the number of stages to run
+	 * @return the state of the program
+	 */
+	Stages prepare(std::shared_ptr<RawProgram> raw, int count) {
+		Stages stages;
+		if (count > 0) stages.parsed = mmix::Parser(raw, stages.arena, stages.symbols).get();
+		if (count > 1) stages.macroprocessed = 
+			mmix::Macroprocessor(stages.parsed, stages.arena, stages.symbols).get();
+		if (count > 2) stages.preprocessed = 
+			mmix::Preprocessor(stages.macroprocessed, stages.arena, stages.symbols).get();
+		return stages;
+	}
+
+	/**
+	 * Check the encoders of the hex output against the scalar one on
+	 * random octabytes (an odd number of them, so the tails are checked too)
+	 * @return false if an encoder gives different lines
+	 */
+	bool check_hex(void) {
+		std::mt19937_64 		random(1);
+		std::vector<uint64_t> 	values{0, ~0ULL, 0x0123456789ABCDEFULL};
+		for (int index = 0; index < 10000; ++index) values.push_back(random());
+
+		auto paths = mmix::hex::paths();
+		std::string expected(values.size() * mmix::hex::line_size, '\0');
+		paths.front().encode(values.data(), values.size(), expected.data());
+
+		std::string result(expected.size(), '\0');
+		for (const auto& path : paths) {
+			path.encode(values.data(), values.size(), result.data());
+			if (result != expected) {
+				std::cerr << "hex/" << path.name << " differs from the scalar encoder" << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Check the entry point of MMO objects in every segment : "lop_post"
+	 * and the equivalent of ":Main" in the symbol table must be its address
+	 * @return false if an object is broken
+	 */
+	bool check_mmo(void) {
+		for (auto [location, entry] : std::vector<std::pair<std::string, uint64_t>>{
+			{"#100", 0x100}, 
+			{"Data_Segment", mmix::constants::data_segment}, 
+			{"#2000000000000010", mmix::constants::data_segment + 0x10}, 
+			{"Pool_Segment", mmix::constants::pool_segment}, 
+			{"Stack_Segment", mmix::constants::stack_segment}}) {
+			auto content = " LOC " + location + "\nMain ADD $1,$2,$3\n";
+			auto object = *mmix::Assembler({mmix::assembler::Source{"main.mms", content}}).object();
+
+			auto tetra = [&object](size_t index) {
+				uint32_t value = 0;
+				for (size_t byte = index * 4; byte < index * 4 + 4; ++byte) 
+					value = (value << 8) | static_cast<uint8_t>(object[byte]);
+				return value;
+			};
+
+			// The object ends with "lop_post", "lop_stab", the table and "lop_end"
+			size_t tetras 	= object.size() / 4;
+			size_t table 	= tetras - 1 - (tetra(tetras - 1) & 0xFFFF);
+			uint64_t post 	= (static_cast<uint64_t>(tetra(table - 3)) << 32) | tetra(table - 2);
+
+			// The trie of ":Main" : the prefix, the master byte, "n" and the equivalent
+			size_t master 	= table * 4 + 8;
+			uint8_t bytes 	= static_cast<uint8_t>(object[master]);
+			uint64_t value 	= bytes > 8 ? mmix::constants::data_segment : 0;
+			uint64_t equivalent = 0;
+			for (uint8_t byte = 0; byte < (bytes > 8 ? bytes - 8 : bytes); ++byte) 
+				equivalent = (equivalent << 8) | static_cast<uint8_t>(object[master + 2 + byte]);
+
+			if (post != entry or bytes == 0 or bytes > 14 or value + equivalent != entry) {
+				std::cerr << "mmo/entry is broken for " << location << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+} // namespace
+
+int main(int argc, char** argv) {
+	// Add options
+	boost::program_options::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "produce help message")
+		("json", boost::program_options::bool_switch()->default_value(false), "Write the results as JSON")
+		("output,o", boost::program_options::value<std::string>(), "File to write the results to")
+		("min-time", boost::program_options::value<double>()->default_value(0.5), "Minimal measured "
+			"time of a benchmark in seconds")
+		("max-lines", boost::program_options::value<uint64_t>()->default_value(100000), "The size of "
+			"the biggest end-to-end program (powers of 10 from 1000)")
+		("filter", boost::program_options::value<std::string>()->default_value(""), "Run only the "
+			"benchmarks containing the string");
+
+	// Parse arguments
+	boost::program_options::variables_map vm;
+	boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+		options(desc).run(), vm);
+	boost::program_options::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << "Usage: bench [options]" << std::endl << desc;
+		return 0;
+	}
+
+	// The generated programs are stored in a temporary directory of the process,
+	// so the benchmarks running at the same time don't remove each other's files
+#ifndef _WIN32
+	auto process = std::to_string(getpid());
+#else
+	auto process = std::to_string(_getpid());
+#endif // _WIN32
+	auto directory = std::filesystem::temp_directory_path() / ("mmix-bench-" + process);
+	std::filesystem::create_directories(directory);
+
+	Runner runner(vm["min-time"].as<double>(), vm["filter"].as<std::string>());
+
+	// Every encoder of the hex output must give the same lines as the scalar one,
+	// the objects must start at "Main" in every segment
+	if (not check_hex() or not check_mmo()) {
+		std::filesystem::remove_all(directory);
+		return 1;
+	}
+
+	// Micro-benchmarks of the hot functions of the stages
+	const uint64_t lines = 10000;
+	{
+		auto raw = read(write(directory, Program::MIXED, lines));
+		auto& file = *raw->begin()->second;
+
+		runner.run("lexer/tokenize", lines, [] { return mmix::lexer::Tokens(); }, [&](auto& tokens) {
+			for (auto line : file) mmix::Lexer::tokenize(line, tokens);
+		});
+
+		runner.run("keywords/find", lines, [] { return 0; }, [&](int) {
+			const auto count = std::size(mmix::compiler::mnemonics);
+			for (uint64_t index = 0; index < lines; ++index) 
+				if (not mmix::keywords::find(mmix::compiler::mnemonics[index % count].first)) std::abort();
+		});
+
+		runner.run("parser/parse", lines, [&] { return prepare(raw, 0); }, [&](auto& stages) {
+			mmix::Parser(raw, stages.arena, stages.symbols);
+		});
+	}
+
+	{
+		auto raw = read(write(directory, Program::MACROS, lines));
+		runner.run("macroprocessor/replace_macros", lines, [&] { return prepare(raw, 1); }, [](auto& stages) {
+			mmix::Macroprocessor(stages.parsed, stages.arena, stages.symbols);
+		});
+	}
+
+	{
+		auto raw = read(write(directory, Program::LABELS, lines));
+		runner.run("preprocessor/labels", lines, [&] { return prepare(raw, 2); }, [](auto& stages) {
+			mmix::Preprocessor(stages.macroprocessed, stages.arena, stages.symbols);
+		});
+	}
+
+	{
+		auto raw = read(write(directory, Program::BLOCKS, lines));
+		runner.run("preprocessor/blocks", lines, [&] { return prepare(raw, 2); }, [](auto& stages) {
+			mmix::Preprocessor(stages.macroprocessed, stages.arena, stages.symbols);
+		});
+	}
+
+	{
+		auto raw = read(write(directory, Program::DATA, lines));
+		runner.run("compiler/compile", lines, [&] { return prepare(raw, 3); }, [](auto& stages) {
+			mmix::Compiler(stages.preprocessed, stages.arena, stages.symbols);
+		});
+	}
+
+	{
+		std::vector<uint64_t> codes(lines);
+		for (uint64_t index = 0; index < lines; ++index) codes[index] = index * 0x9E3779B97F4A7C15ULL;
+
+		std::string buffer(lines * mmix::hex::line_size, '\0');
+		runner.run("hex/encode", lines, [] { return 0; }, [&](int) {
+			mmix::hex::encode(codes.data(), codes.size(), buffer.data());
+		});
+
+		for (const auto& path : mmix::hex::paths()) {
+			runner.run("hex/encode/" + std::string(path.name), lines, [] { return 0; }, [&](int) {
+				path.encode(codes.data(), codes.size(), buffer.data());
+			});
+		}
+	}
+
+	// End-to-end benchmarks on programs of growing sizes
+	auto max_lines = vm["max-lines"].as<uint64_t>();
+	for (uint64_t size = 1000; size <= max_lines; size *= 10) {
+		auto input 	= write(directory, Program::MIXED, size);
+		auto output = (directory / "output.hex").string();
+
+		runner.run("assembler/" + std::to_string(size), size, [] { return 0; }, [&](int) {
+			Application application(std::vector<std::string>{input}, output);
+			application.start();
+		});
+	}
+
+	// Write the results
+	bool json = vm["json"].as<bool>();
+	if (vm.count("output")) {
+		std::ofstream stream(vm["output"].as<std::string>());
+		runner.report(stream, json);
+	}
+	else runner.report(std::cout, json);
+
+	std::filesystem::remove_all(directory);
+	return 0;
+}
@@ -26,12 +26,18 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <filesystem>
 
 // Include project headers
+#include "assembler.h"
 #include "macroprocessor.h"
 #include "compiler.h"
 #include "preprocessor.h"
 #include "parser.h"
+#include "mmo.h"
+#include "hex.h"
+#include "stats.h"
+#include "trace.h"
 
 /**
  * The class that represents the application. It starts the
@@ -49,6 +55,23 @@ public:
 		COMPILATION
 	};
 
+	/**
+	 * The enum holds the formats of the compiled program
+	 */
+	enum OutputFormat {
+		HEX = 0,
+		MMO
+	};
+
+	/**
+	 * The enum holds the formats of the statistics
+	 */
+	enum StatsFormat {
+		NONE = 0,
+		TEXT,
+		JSON
+	};
+
 public :
     /**
      * Constructor
@@ -63,18 +86,119 @@ public :
 	 */
 	void set_mode(const CompilationMode& value);
 
+	/**
+	 * Set the format of the compiled program
+	 * @param value format of the output file
+	 */
+	void set_format(const OutputFormat& value);
+
+	/**
+	 * Set the number of threads parsing the files
+	 * @param value the number of threads (0 means the number of cores)
+	 */
+	void set_jobs(size_t value);
+
+	/**
+	 * Set the directory of the cache of parsed files
+	 * @param value the directory (empty disables the cache)
+	 */
+	void set_cache(const std::string& value);
+
+	/**
+	 * Enable the pipelined mode : the instructions are compiled
+	 * while the preprocessor places the rest of them
+	 * @param value true to enable the mode
+	 */
+	void set_pipeline(bool value);
+
+	/**
+	 * Enable the statistics of the stages, they are written
+	 * to the standard output after the program is built
+	 * @param value format of the statistics (NONE disables them)
+	 */
+	void set_stats(const StatsFormat& value);
+
+	/**
+	 * Enable the tracing of the stages, the spans are written
+	 * as Chrome trace events after the program is built
+	 * @param value the file of the trace (empty disables the tracing)
+	 */
+	void set_trace(const std::string& value);
+
+	/**
+	 * Set the directory the relative paths of the build are resolved
+	 * against (the names of the files stay as they are given)
+	 * @param value the directory (empty means the working directory)
+	 */
+	void set_directory(const std::string& value);
+
+	/**
+	 * Add a source file from the memory, it's used instead of the file with
+	 * the same name (an input or an included file)
+	 * @param name the name of the file
+	 * @param content the content of the file
+	 */
+	void add_source(const std::string& name, std::string content);
+
+	/**
+	 * Add a source file which is already read (it can be shared between builds)
+	 * @param name the name of the file
+	 * @param file the file
+	 */
+	void add_source(const std::string& name, std::shared_ptr<mmix::parser::RawFile> file);
+
+	/**
+	 * Set the stream of the reports (the statistics)
+	 * @param value the stream, it must outlive the execution
+	 */
+	void set_report(std::ostream& value);
+
     /**
      * Start the execution
      */
     void start(void);
 
 protected :
+	static constexpr size_t batch_size = 4096;						// The number of lines encoded at once
+
 	std::shared_ptr<mmix::Compiler> compiler_;						// MMIX compiler
 	std::vector<std::string> 		input_files_;					// The file with the original program
 	std::string 					output_file_{""};				// The file to write the compiled program to
 	CompilationMode 				mode_{CompilationMode::FULL};	//
+	OutputFormat 					format_{OutputFormat::HEX};		// The format of the compiled program
+	size_t 							jobs_{1};						// The number of threads parsing the files
+	std::string 					cache_;							// The directory of the cache of parsed files
+	bool 							pipeline_{false};				// Compile while the program is being placed
+	std::shared_ptr<mmix::Statistics> stats_;						// Statistics of the stages (null if disabled)
+	StatsFormat 					stats_format_{StatsFormat::NONE};	// The format of the statistics
+	std::string 					trace_;							// The file of the trace
+	std::filesystem::path 			directory_;						// The base of the relative paths
+	std::shared_ptr<mmix::parser::RawProgram> sources_;				// The files which are already read
+	std::ostream* 					report_{&std::cout};			// The stream of the reports
 
 protected:
+	/**
+	 * Resolve a path against the directory of the build
+	 * @param path the path
+	 * @return the path to open
+	 */
+	std::string resolve(const std::string& path) const;
+
+	/**
+	 * Run a stage of the build, it's measured if the statistics are enabled
+	 * and traced if the tracing is enabled
+	 * @param name the name of the stage
+	 * @param function the stage
+	 * @return the result of the stage
+	 */
+	template <typename Function>
+	auto stage(const std::string& name, Function function) {
+		mmix::trace::Span span("stage", name);
+
+		if (stats_) return stats_->measure(name, function);
+		return function();
+	}
+
 	/**
 	 * Read program from the given file
 	 * @return array of program's lines
@@ -87,6 +211,21 @@ protected:
 	 */
 	void write(std::shared_ptr<mmix::compiler::CompiledProgram> program);
 
+	/**
+	 * Encode octabytes as lines of the hex output and write them at once
+	 * @param output_stream the stream to write to
+	 * @param codes the octabytes to write
+	 * @param buffer the storage of the lines (reused between the calls)
+	 */
+	static void write_lines(std::ostream& output_stream, const mmix::compiler::Chunk& codes, std::string& buffer);
+
+	/**
+	 * Write the compiled program into the given file as an MMO object
+	 * @param program the program to write
+	 * @param entry the address of "Main"
+	 */
+	void write_object(std::shared_ptr<mmix::compiler::CompiledProgram> program, uint64_t entry);
+
 	/**
 	 * Write the preprocessed program program into the given file
 	 * @param program the program to write
@@ -0,0 +1,224 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <stdexcept>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace mmix {
+	/**
+	 * A view of an array, which is stored somewhere else
+	 * (usually in an arena)
+	 */
+	template <typename T>
+	class Span {
+	public:
+		using iterator 			= T*;
+		using const_iterator 	= const T*;
+
+	protected:
+		T* 		data_{nullptr};		// The first element
+		size_t 	size_{0};			// The number of elements
+
+	public:
+		/**
+		 * Constructor
+		 */
+		Span(void) = default;
+
+		/**
+		 * Constructor
+		 * @param data the first element
+		 * @param size the number of elements
+		 */
+		Span(T* data, size_t size) : data_{data}, size_{size} {}
+
+		T* begin(void) const { return data_; }
+		T* end(void) const { return data_ + size_; }
+		T& front(void) const { return data_[0]; }
+		T& back(void) const { return data_[size_ - 1]; }
+		T& operator[](size_t index) const { return data_[index]; }
+		size_t size(void) const { return size_; }
+		bool empty(void) const { return size_ == 0; }
+
+		/**
+		 * Get an element with a bounds check
+		 * @param index the index of the element
+		 * @return the element
+		 */
+		T& at(size_t index) const {
+			if (index >= size_) throw std::out_of_range("Span index is out of range");
+			return data_[index];
+		}
+	};
+
+	/**
+	 * Bump allocator. The objects are allocated in big chunks
+	 * and are all freed at once when the arena is destroyed,
+	 * so only trivially destructible types can be stored.
+	 */
+	class Arena {
+	protected:
+		static constexpr size_t chunk_size = 64 * 1024;				// The size of a regular chunk
+
+		std::vector<std::unique_ptr<char[]>> 	chunks_;		// Allocated chunks
+		char* 									position_{nullptr};	// The free space in the last chunk
+		size_t 									available_{0};		// The size of the free space
+		size_t 									used_{0};			// The number of allocated bytes
+
+	public:
+		/**
+		 * Constructor
+		 */
+		Arena(void) = default;
+
+		/**
+		 * The memory can't be shared between arenas
+		 */
+		Arena(const Arena& other) = delete;
+		Arena& operator=(const Arena& other) = delete;
+
+		/**
+		 * Allocate raw memory
+		 * @param size the size of the memory
+		 * @param alignment the alignment of the memory
+		 * @return pointer to the memory
+		 */
+		void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			size_t padding = (alignment - reinterpret_cast<uintptr_t>(position_) % alignment) % alignment;
+
+			// Start a new chunk if the current one is full
+			if (padding + size > available_) {
+				size_t capacity = std::max(size + alignment, chunk_size);
+				chunks_.emplace_back(new char[capacity]);
+
+				position_ 	= chunks_.back().get();
+				available_ 	= capacity;
+				padding 	= (alignment - reinterpret_cast<uintptr_t>(position_) % alignment) % alignment;
+			}
+
+			void* result = position_ + padding;
+			position_ 	+= padding + size;
+			available_ 	-= padding + size;
+			used_ 		+= size;
+
+			return result;
+		}
+
+		/**
+		 * Create an object in the arena
+		 * @param args arguments of the constructor
+		 * @return pointer to the object
+		 */
+		template <typename T, typename... Args>
+		T* create(Args&&... args) {
+			static_assert(std::is_trivially_destructible_v<T>, "Arena doesn't call destructors");
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Create an array of default constructed elements in the arena
+		 * @param size the number of elements
+		 * @return view of the array
+		 */
+		template <typename T>
+		Span<T> array(size_t size) {
+			static_assert(std::is_trivially_destructible_v<T>, "Arena doesn't call destructors");
+
+			auto data = static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+			for (size_t index = 0; index < size; ++index) new (data + index) T();
+
+			return Span<T>(data, size);
+		}
+
+		/**
+		 * Copy elements into the arena
+		 * @param first the first element to copy
+		 * @param last the end of the elements
+		 * @return view of the copy
+		 */
+		template <typename T, typename Iterator>
+		Span<T> copy(Iterator first, Iterator last) {
+			static_assert(std::is_trivially_destructible_v<T>, "Arena doesn't call destructors");
+
+			auto size 	= static_cast<size_t>(std::distance(first, last));
+			auto data 	= static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+			for (size_t index = 0; first != last; ++first, ++index) new (data + index) T(*first);
+
+			return Span<T>(data, size);
+		}
+
+		/**
+		 * Copy a string into the arena
+		 * @param value the string to copy
+		 * @return view of the copy
+		 */
+		std::string_view copy(std::string_view value) {
+			if (value.empty()) return std::string_view();
+
+			auto data = static_cast<char*>(allocate(value.size(), 1));
+			std::memcpy(data, value.data(), value.size());
+
+			return std::string_view(data, value.size());
+		}
+
+		/**
+		 * Take over the memory of another arena, the objects of
+		 * the other arena live as long as this one afterwards
+		 * @param other the arena to empty
+		 */
+		void merge(Arena& other) {
+			// The current chunk stays the same, the new ones are just kept
+			for (auto& chunk : other.chunks_) chunks_.push_back(std::move(chunk));
+			used_ += other.used_;
+
+			other.chunks_.clear();
+			other.position_ 	= nullptr;
+			other.available_ 	= 0;
+			other.used_ 		= 0;
+		}
+
+		/**
+		 * Get the number of allocated bytes
+		 * @return the number of bytes
+		 */
+		size_t size(void) const {
+			return used_;
+		}
+
+		/**
+		 * Get the number of allocated chunks
+		 * @return the number of chunks
+		 */
+		size_t chunks(void) const {
+			return chunks_.size();
+		}
+	};
+} // namespace mmix
@@ -0,0 +1,170 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+// Include project headers
+#include "arena.h"
+#include "symbols.h"
+#include "cache.h"
+#include "parser.h"
+#include "macroprocessor.h"
+#include "preprocessor.h"
+#include "compiler.h"
+#include "mmo.h"
+
+namespace mmix {
+	namespace assembler {
+		/**
+		 * A source file in the memory
+		 */
+		struct Source {
+			std::string_view name;			// The name of the file (used by "INCLUDE")
+			std::string_view content;		// The content of the file
+		};
+
+		/**
+		 * A contiguous run of the compiled memory
+		 */
+		struct Segment {
+			uint64_t 			origin;		// The address of the first byte
+			Span<const uint8_t> bytes;		// The bytes (valid as long as the assembler exists)
+		};
+
+		using Stage = std::function<void(const std::string&, const std::function<void()>&)>;	// Runs a stage of the build
+
+		/**
+		 * The options of a build
+		 */
+		struct Options {
+			size_t 					jobs{1};			// The number of threads parsing the files (0 means every core)
+			std::shared_ptr<Cache> 	cache;				// The cache of parsed files (optional)
+			bool 					compile{true};		// Stop after the preprocessing if not set
+			bool 					pipeline{false};	// Compile the instructions while they are being placed
+			Stage 					stage;				// Wraps every stage, e.g. to measure it (optional)
+		};
+	} // namespace assembler
+
+	/**
+	 * The assembler of a program in the memory : it runs the stages from
+	 * the parser to the compiler without touching the filesystem and
+	 * keeps the results, which are valid as long as the object exists.
+	 */
+	class Assembler {
+	protected:
+		std::shared_ptr<Arena> 								arena_;			// The storage of the instructions
+		std::shared_ptr<SymbolTable> 						symbols_;		// The interned identifiers
+		std::shared_ptr<parser::RawProgram> 				raw_;			// The source files
+		std::shared_ptr<preprocessor::PreprocessedProgram> 	preprocessed_;	// The preprocessed program
+		std::shared_ptr<Compiler> 							compiler_;		// The compiler (if the program was compiled)
+		size_t 												labels_{0};		// The number of label definitions
+
+	protected:
+		/**
+		 * Run the stages
+		 * @param options the options of the build
+		 */
+		void assemble(const assembler::Options& options);
+
+	public:
+		/**
+		 * Constructor. The sources aren't copied, they must outlive the object.
+		 * @param sources the source files
+		 * @param options the options of the build
+		 */
+		explicit Assembler(const std::vector<assembler::Source>& sources, 
+			const assembler::Options& options = assembler::Options());
+
+		/**
+		 * Constructor
+		 * @param program the source files
+		 * @param options the options of the build
+		 */
+		explicit Assembler(std::shared_ptr<parser::RawProgram> program, 
+			const assembler::Options& options = assembler::Options());
+
+		/**
+		 * Get the compiled memory
+		 * @return the extents of the memory in the order of addresses
+		 */
+		std::vector<assembler::Segment> segments(void) const;
+
+		/**
+		 * Get the compiled program
+		 * @return the image of the memory (null if the program wasn't compiled)
+		 */
+		std::shared_ptr<compiler::CompiledProgram> image(void) const;
+
+		/**
+		 * Encode the compiled program in the hex format
+		 * @return the lines of the hex output
+		 */
+		std::string hex(void) const;
+
+		/**
+		 * Encode the compiled program as an MMO object
+		 * @return the object
+		 */
+		std::shared_ptr<mmo::Buffer> object(void) const;
+
+		/**
+		 * Get the preprocessed program
+		 * @return the program
+		 */
+		std::shared_ptr<preprocessor::PreprocessedProgram> preprocessed(void) const;
+
+		/**
+		 * Get the number of label definitions in the program
+		 * @return the number of labels
+		 */
+		size_t labels(void) const;
+
+		/**
+		 * Get the source files
+		 * @return the files
+		 */
+		std::shared_ptr<parser::RawProgram> sources(void) const;
+
+		/**
+		 * Get the storage of the instructions
+		 * @return the arena
+		 */
+		std::shared_ptr<Arena> arena(void) const;
+
+		/**
+		 * Get the interned identifiers
+		 * @return the symbol table
+		 */
+		std::shared_ptr<SymbolTable> symbols(void) const;
+
+		/**
+		 * Get the compiler
+		 * @return the compiler (null if the program wasn't compiled)
+		 */
+		std::shared_ptr<Compiler> compiler(void) const;
+	};
+} // namespace mmix
@@ -0,0 +1,131 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <iostream>
+
+// Include project headers
+#include "application.h"
+#include "parser.h"
+#include "pool.h"
+
+namespace mmix {
+	namespace batch {
+		/**
+		 * A program of the batch
+		 */
+		struct Job {
+			std::vector<std::string> 	inputs;		// The input files
+			std::string 				output;		// The output file
+			size_t 						line;		// The line of the manifest
+		};
+
+		/**
+		 * The result of a job
+		 */
+		struct Result {
+			std::string output;			// The reports of the build (e.g. the statistics)
+			std::string error;			// The error of the build (empty if it succeeded)
+			double 		seconds{0};		// The wall time of the build
+		};
+
+		using Configure = std::function<std::shared_ptr<Application>(const Job&)>;	// Creates the application of a job
+	} // namespace batch
+
+	/**
+	 * Assembler of many independent programs. The manifest has a job per
+	 * line : the input files, "->" and the output file ("#" starts a comment).
+	 * The jobs run on a work-stealing pool, an error fails only its own job.
+	 * A file used by several jobs (e.g. a library) is read once and shared.
+	 */
+	class Batch {
+	protected:
+		using Files = std::map<std::string, std::shared_future<std::shared_ptr<parser::RawFile>>>;
+
+		std::vector<batch::Job> 	jobs_;			// The jobs of the manifest
+		std::vector<batch::Result> 	results_;		// The results in the order of the jobs
+		Files 						files_;			// The files read by the jobs
+		std::mutex 					mutex_;			// Guards the files
+		double 						seconds_{0};	// The wall time of the batch
+
+	protected:
+		/**
+		 * Read the jobs from the manifest
+		 * @param manifest the file of the manifest
+		 */
+		void read_manifest(const std::string& manifest);
+
+		/**
+		 * Get a file, it's read by the first job which needs it
+		 * @param name the name of the file
+		 * @return the file
+		 */
+		std::shared_ptr<parser::RawFile> file(const std::string& name);
+
+		/**
+		 * Build a job
+		 * @param job the job
+		 * @param configure the function which creates the application
+		 * @return the result of the build
+		 */
+		batch::Result run(const batch::Job& job, const batch::Configure& configure);
+
+	public:
+		/**
+		 * Constructor. The jobs are built before it returns.
+		 * @param manifest the file of the manifest
+		 * @param configure the function which creates the application of a job
+		 * @param threads the number of threads (0 means the number of cores)
+		 */
+		Batch(const std::string& manifest, const batch::Configure& configure, size_t threads);
+
+		/**
+		 * Get the jobs
+		 * @return the jobs in the order of the manifest
+		 */
+		const std::vector<batch::Job>& jobs(void) const;
+
+		/**
+		 * Get the results
+		 * @return the results in the order of the jobs
+		 */
+		const std::vector<batch::Result>& results(void) const;
+
+		/**
+		 * Get the number of failed jobs
+		 * @return the number of jobs with an error
+		 */
+		size_t failed(void) const;
+
+		/**
+		 * Write the reports of the jobs, the errors and the summary
+		 * @param stream the output stream
+		 */
+		void report(std::ostream& stream) const;
+	};
+} // namespace mmix
@@ -0,0 +1,146 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+// Include project headers
+#include "instruction.h"
+#include "arena.h"
+#include "symbols.h"
+#include "keywords.h"
+
+namespace mmix {
+	/**
+	 * On-disk cache of parsed files. An entry is keyed by the
+	 * hash of the content of a file, so an unchanged file is
+	 * loaded instead of being parsed again. Parsing depends on
+	 * nothing but the content : "INCLUDE" and "DEFINE" are
+	 * resolved later by the macroprocessor from the cached
+	 * instructions.
+	 *
+	 * An entry is a header (magic, version, size and hash of
+	 * the content, fingerprint of the keyword table, the "Main"
+	 * flag, the number of instructions and symbols and the size
+	 * of the strings) followed by the content, the strings and
+	 * the records of the instructions. The 64-bit hash can collide,
+	 * so an entry is used only if the stored content is the same
+	 * as the file's one. The strings are copied into the arena
+	 * at once and the operands are decoded right into it, so a
+	 * loaded entry takes only a few allocations. Opcodes are
+	 * stored as indexes of the keyword table, numbers with
+	 * their values and symbols as indexes of the entry's own
+	 * symbols, which are interned in the same order as the
+	 * parser does it.
+	 */
+	class Cache {
+	public:
+		using Instructions = std::vector<Instruction*>;
+
+	protected:
+		static const uint32_t version = 4;		// Version of the entry format
+
+		/**
+		 * State of an entry being written
+		 */
+		struct Encoder {
+			std::string 								records;	// Records of the instructions
+			std::string 								strings;	// Labels and texts of the operands
+			std::unordered_map<symbols::Id, uint32_t> 	symbols;	// Indexes of the symbols in the entry
+		};
+
+		/**
+		 * State of an entry being read
+		 */
+		struct Decoder {
+			std::string_view 			records;	// The remaining records
+			std::string_view 			strings;	// The remaining strings (stored in the arena)
+			std::vector<symbols::Id> 	symbols;	// IDs of the symbols in the entry
+			Arena& 						arena;		// The storage of the instructions
+			SymbolTable& 				table;		// The table to intern the symbols into
+		};
+
+		std::string directory_;					// The directory of the entries
+
+	protected:
+		/**
+		 * Get the path of the entry
+		 * @param hash the hash of the content
+		 * @return the path
+		 */
+		std::string path(uint64_t hash) const;
+
+		/**
+		 * Serialize an instruction
+		 * @param instruction the instruction to write
+		 * @param encoder the entry to append the instruction to
+		 */
+		static void write(const Instruction* instruction, Encoder& encoder);
+
+		/**
+		 * Deserialize an instruction
+		 * @param decoder the entry (moved past the instruction)
+		 * @return the instruction (nullptr if the data is broken)
+		 */
+		static Instruction* read(Decoder& decoder);
+
+	public:
+		/**
+		 * Constructor. The directory is created if it doesn't exist.
+		 * @param directory the directory of the entries
+		 */
+		explicit Cache(const std::string& directory);
+
+		/**
+		 * Get the FNV-1a hash of the content
+		 * @param content the content to hash
+		 * @return the hash
+		 */
+		static uint64_t hash(std::string_view content);
+
+		/**
+		 * Load the parsed file
+		 * @param content the content of the file
+		 * @param instructions the vector to push the instructions to
+		 * @param is_main set to true if the file has the "Main" label
+		 * @param arena the storage of the instructions
+		 * @param symbols the table to intern the identifiers into
+		 * @return false if there is no valid entry for the content
+		 */
+		bool load(std::string_view content, 
+			Instructions& instructions, 
+			bool& is_main, 
+			Arena& arena, 
+			SymbolTable& symbols) const;
+
+		/**
+		 * Store the parsed file, errors are ignored (the entry is just missing then)
+		 * @param content the content of the file
+		 * @param instructions the instructions of the file
+		 * @param is_main true if the file has the "Main" label
+		 */
+		void store(std::string_view content, const Instructions& instructions, bool is_main) const;
+	};
+} // namespace mmix
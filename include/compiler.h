@@ -21,58 +21,186 @@
 
 // Include C++ STL headers
 #include <vector>
-#include <map>
 #include <string>
+#include <optional>
+#include <utility>
 
 // Include project headers
 #include "instruction.h"
-#include "mnemonics.h"
-#include "sizes.h"
+#include "arena.h"
+#include "symbols.h"
+#include "keywords.h"
+#include "lexer.h"
+#include "exceptions.h"
+#include "memory.h"
+#include "trace.h"
 #include "preprocessor.h"
 
 namespace mmix {
 	namespace compiler {
-		using CompiledProgram = std::vector<uint64_t>;
-	}
+		using CompiledProgram 	= memory::Image<uint8_t>;				// Bytes of the memory
+		using Chunk 			= std::vector<uint64_t>;				// Octabytes in the order of addresses
+
+		static constexpr uint64_t octa_size 	= 8;		// The number of bytes in an octabyte
+		static constexpr uint64_t tetra_size 	= 4;		// The size of an instruction
+
+		/**
+		 * Split every extent of the program into big-endian octabytes
+		 * (the last one of an extent is padded with zeros)
+		 * @param program the compiled program
+		 * @param function the function to call for every octabyte
+		 */
+		template <typename Function>
+		void for_each_octa(const CompiledProgram& program, Function function) {
+			for (const auto& [origin, extent] : program) {
+				for (size_t index = 0; index < extent.size(); index += octa_size) {
+					uint64_t octa = 0;
+					for (size_t byte = index; byte < index + octa_size; ++byte) 
+						octa = (octa << 8) | (byte < extent.size() ? extent[byte] : 0);
+					function(octa);
+				}
+			}
+		}
+	} // namespace compiler
 
 	/**
-	 * The compiler of MMIX instructions
+	 * The compiler of MMIX instructions. The program is compiled into
+	 * a byte-addressed image : an instruction is an aligned tetrabyte
+	 * and data is aligned to its size, as MMIXAL does.
 	 */
-	 // FIXME : addresses should be instruction_number * obj_entry_size
 	class Compiler {
 	protected :		
-		using AllocatedData = std::pair<const std::string, uint64_t>;
-		using DataTable 	= std::map<std::string, uint64_t>;
+		using DataTable = std::vector<std::optional<uint64_t>>;		// Addresses indexed by the symbol IDs
 
-		// FIXME : store an instance of Lexer class
+		/**
+		 * A field which depends on a label defined later
+		 */
+		struct Fixup {
+			uint64_t 		address;	// The address of the big-endian value which contains the field
+			const Operand* 	operand;	// The label
+			uint8_t 		size;		// The size of the value in bytes
+			uint8_t 		shift;		// The position of the field in the value
+			uint8_t 		width;		// The width of the field in bits
+		};
 
-		std::shared_ptr<preprocessor::PreprocessedProgram> 	program_;		// The preprocessed program
-		std::shared_ptr<compiler::CompiledProgram> 			compiled_;		// The compiled sources
-		std::shared_ptr<DataTable>							data_table_;	// Table of addresses of the allocated data
+		std::shared_ptr<preprocessor::PreprocessedProgram> 	program_;			// The preprocessed program
+		std::shared_ptr<compiler::CompiledProgram> 			compiled_;			// The compiled sources
+		std::shared_ptr<DataTable>							data_table_;		// Table of addresses of the labels
+		std::shared_ptr<Arena> 								arena_;				// The storage of the instructions
+		std::shared_ptr<SymbolTable> 						symbols_;			// The interned identifiers of the program
+		std::vector<Fixup> 									fixups_;			// Fields waiting for the labels
+		bool 												sequential_{true};	// The bytes were compiled in the order of addresses
 
 	protected :
 		/**
-		 * Allocate data for the value
+		 * Get the size of data in bytes
+		 * @param size the name of the size (e.g. "WYDE")
+		 * @return the number of bytes
+		 */
+		static uint8_t size_of(std::string_view size);
+
+		/**
+		 * Round the address up to a multiple of the alignment
+		 * @param address the address
+		 * @param alignment a power of 2
+		 * @return the aligned address
+		 */
+		static uint64_t align(uint64_t address, uint64_t alignment) {
+			return (address + alignment - 1) & ~(alignment - 1);
+		}
+
+		/**
+		 * Check if the value fits the size of data, as an unsigned
+		 * number or as a negative one (e.g. "BYTE -1")
+		 * @param value the value
+		 * @param size the size of the data in bytes
+		 * @return true if nothing is lost when the value is truncated
+		 */
+		static bool fits(uint64_t value, uint8_t size) {
+			if (size >= compiler::octa_size) return true;
+
+			auto bits = size * 8;
+			return (value >> bits) == 0 or (static_cast<int64_t>(value) >> (bits - 1)) == -1;
+		}
+
+		/**
+		 * Allocate data for every character of the string
 		 * @param size the size of the data
 		 * @param value the value to store in the allocated space
 		 */
-		void allocate(std::string size, std::string value);
+		void allocate(std::string_view size, std::string_view value);
 
 		/**
 		 * Allocate data for the value
 		 * @param size the size of the data
 		 * @param value the value to store in the allocated space
 		 */
-		void allocate(std::string size, uint32_t value);
+		void allocate(std::string_view size, uint64_t value);
+
+		/**
+		 * Allocate data for a label defined later
+		 * @param size the size of the data
+		 * @param operand the label
+		 */
+		void allocate(std::string_view size, const Operand& operand);
+
+		/**
+		 * Write a big-endian value at the current address
+		 * @param value the value to write
+		 * @param size the size of the value in bytes
+		 */
+		void emit(uint64_t value, uint8_t size);
+
+		/**
+		 * Write zeros up to an aligned address
+		 * @param alignment a power of 2
+		 */
+		void pad(uint64_t alignment);
+
+		/**
+		 * Record a field of the next value which depends on a label defined later
+		 * @param operand the label
+		 * @param size the size of the value in bytes
+		 * @param shift the position of the field in the value
+		 * @param width the width of the field in bits
+		 */
+		void defer(const Operand& operand, uint8_t size, uint8_t shift, uint8_t width);
+
+		/**
+		 * Fill the fields which depend on labels
+		 */
+		void resolve(void);
+
+		/**
+		 * Check if the operand is a label which isn't defined yet
+		 * @param operand the operand to check
+		 * @return true if the value of the operand must be deferred
+		 */
+		static bool is_forward(const Operand& operand);
+
+		/**
+		 * Get the value of an operand
+		 * @param operand the operand to decode
+		 * @return the value
+		 */
+		static uint64_t value(const Operand& operand);
 
 		/**
 		 * Convert instruction into digital representation
 		 * @param instruction the instruction to convert
 		 */
-		void convert(std::shared_ptr<Mnemonic>& instruction);
+		void convert(Mnemonic* instruction);
 
 		/**
-		 * Fill the table of addresses
+		 * Define the label of an instruction at the address (the first definition is kept)
+		 * @param instruction the instruction
+		 * @param address the address of the instruction
+		 */
+		void define(const Instruction* instruction, uint64_t address);
+
+		/**
+		 * Fill the table of addresses before the compilation
+		 * (so the program can be compiled again without fixups)
 		 */
 		void fill_table(void);
 
@@ -83,21 +211,63 @@ namespace mmix {
 		void replace_labels(Instruction::Parameters& parameters);
 
 		/**
-		 * Compile the program
+		 * Compile an instruction at the current address
+		 * @param instruction the instruction to compile
+		 */
+		void compile(Instruction* instruction);
+
+		/**
+		 * Compile the program in a single pass, the labels
+		 * defined later are filled by fixups
 		 */
 		void compile(void);
 
+		/**
+		 * Compile the chunks as they come, the labels defined
+		 * later are filled by fixups
+		 * @param stream the chunks of the program
+		 */
+		void compile(preprocessor::Stream& stream);
+
+		/**
+		 * Fill the fixups, the program is compiled again if
+		 * the extents overlap
+		 */
+		void finish(void);
+
 	public :
 		/**
 		 * Constructor
 		 * @param program the program to compile
+		 * @param arena the storage of the instructions
+		 * @param symbols the interned identifiers of the program
+		 */
+		Compiler(std::shared_ptr<preprocessor::PreprocessedProgram> program, 
+			std::shared_ptr<Arena> arena, 
+			std::shared_ptr<SymbolTable> symbols);
+
+		/**
+		 * Constructor. The program is compiled while it's being preprocessed.
+		 * @param stream the chunks of the program from the preprocessor
+		 * @param program the preprocessed program (complete once the stream is closed)
+		 * @param arena the storage of the instructions
+		 * @param symbols the interned identifiers of the program
 		 */
-		Compiler(std::shared_ptr<preprocessor::PreprocessedProgram> program);
+		Compiler(std::shared_ptr<preprocessor::Stream> stream, 
+			std::shared_ptr<preprocessor::PreprocessedProgram> program, 
+			std::shared_ptr<Arena> arena, 
+			std::shared_ptr<SymbolTable> symbols);
 
 		/**
 		 * Get the compiled program
 		 * @return a compiled version of the program
 		 */
 		std::shared_ptr<compiler::CompiledProgram> get(void);
+
+		/**
+		 * Get the address of the label "Main", where the execution starts
+		 * @return the address
+		 */
+		uint64_t entry(void) const;
 	};
 }
\ No newline at end of file
@@ -21,11 +21,36 @@
 
 // Include C library headers
 #include <cstdint>
+
+// Include C++ STL headers
+#include <string_view>
+#include <utility>
+
 namespace mmix {
 	namespace constants {
 		static const uint64_t text_segment = 0;
 		static const uint64_t data_segment = 2305843009213693952;
 		static const uint64_t pool_segment = 4611686018427387904;
 		static const uint64_t stack_segment = 6917529027641081856;
+
+		inline constexpr std::pair<std::string_view, uint64_t> segments[] {
+			{"Text_Segment", text_segment},
+			{"Data_Segment", data_segment},
+			{"Pool_Segment", pool_segment},
+			{"Stack_Segment", stack_segment},
+		};
+
+		/**
+		 * Find a predefined segment by its name
+		 * @param name the name of the segment
+		 * @return the entry of the segment or nullptr if the name is not a segment
+		 */
+		constexpr const std::pair<std::string_view, uint64_t>* find_segment(std::string_view name) {
+			for (const auto& segment : segments) 
+				if (segment.first == name) return &segment;
+			return nullptr;
+		}
+
+		static_assert(find_segment("Data_Segment")->second == data_segment, "Segments must be found by name");
 	} // constants
 } // mmix
\ No newline at end of file
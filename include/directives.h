@@ -20,12 +20,11 @@
 #pragma once
 
 // Include C++ STL headers
-#include <vector>
-#include <string>
+#include <string_view>
 
 namespace mmix {
 	namespace preprocessor {
-		static const std::vector<std::string> directives {
+		inline constexpr std::string_view directives[] {
 			"LOC",
 			"GREG",
 			"IS",
@@ -39,7 +39,7 @@ namespace mmix {
 				 * Constructor
 				 * @param label the label of the blovk that caused the exception
 				 */
-				explicit BlockNotFoundException(std::string& label) : label_{label} {
+				explicit BlockNotFoundException(const std::string& label) : label_{label} {
 					message_ += "\"" + label + "\"";
 				}
 			public:
@@ -66,7 +66,7 @@ namespace mmix {
 				 * Constructor
 				 * @param label the label of the blovk that caused the exception
 				 */
-				explicit BlockExistsException(std::string& label) : label_{label} {
+				explicit BlockExistsException(const std::string& label) : label_{label} {
 					message_ += "\"" + label + "\"";
 				}
 			public:
@@ -92,7 +92,7 @@ namespace mmix {
 				 * Constructor
 				 * @param label the label of the blovk that caused the exception
 				 */
-				explicit BadBlockException(std::string& label) : label_{label} {
+				explicit BadBlockException(const std::string& label) : label_{label} {
 					message_ += "\"" + label + "\"";
 				}
 			public:
@@ -118,7 +118,7 @@ namespace mmix {
 				 * Constructor
 				 * @param label name of the label that caused the exception
 				 */
-				explicit LabelNotFoundException(std::string& label) : label_{label} {
+				explicit LabelNotFoundException(const std::string& label) : label_{label} {
 					message_ += "[" + label + "]";
 				}
 			public:
@@ -144,7 +144,7 @@ namespace mmix {
 				 * Constructor
 				 * @param label name of the label that caused the exception
 				 */
-				explicit UnknownDirectiveException(std::string& directive) : directive_{directive} {
+				explicit UnknownDirectiveException(const std::string& directive) : directive_{directive} {
 					message_ += "[" + directive + "]";
 				}
 			public:
@@ -159,7 +159,49 @@ namespace mmix {
 		} // preprocessor
 
 		namespace compiler {
+			/**
+			 * The exception is thrown when an operand is neither
+			 * a number nor a known label
+			 */
+			class WrongOperandException : public std::exception {
+			protected:
+				std::string operand_;								// The operand that caused the exception
+				std::string message_ = "Wrong operand :  ";		// The message to print
+			public:
+				/**
+				 * Constructor
+				 * @param operand the operand that caused the exception
+				 */
+				explicit WrongOperandException(const std::string& operand) : operand_{operand} {
+					message_ += "[" + operand + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
+
+			/** 
+			 * The exception is thrown when the label "Main" 
+			 * has no address in the compiled program
+			 */
+			class NoEntryPointException : public std::exception {
+			protected:
+				std::string message_ = "The entry point [Main] was not compiled";
 
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
 		} // compiler
 
 		namespace parser {
@@ -242,6 +284,59 @@ namespace mmix {
 					return message_.c_str();
 				}
 			};
+
+			/**
+			 * The exception is thrown at the start of the application
+			 * when the value of a parameter is not supported
+			 */
+			class WrongParameterException : public std::exception {
+			protected:
+				std::string parameter_;													// The parameter that caused the exception
+				std::string message_ = "The value of the parameter is not correct : ";
+			public:
+				/**
+				 * Constructor
+				 * @param parameter the parameter that caused the exception
+				 * @param value the value of the parameter
+				 */
+				WrongParameterException(const std::string parameter, const std::string value) : parameter_{parameter} {
+					message_ += "[" + parameter_ + " = " + value + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
+
+			/**
+			 * The exception is thrown when a line of the
+			 * manifest of a batch is not correct
+			 */
+			class WrongManifestException : public std::exception {
+			protected:
+				std::string line_;														// The line that caused the exception
+				std::string message_ = "The line of the manifest is not correct : ";
+			public:
+				/**
+				 * Constructor
+				 * @param line the line that caused the exception
+				 */
+				explicit WrongManifestException(const std::string& line) : line_{line} {
+					message_ += "[" + line_ + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
 		} // namespace application
 
 		namespace macroprocessor {
@@ -284,7 +379,7 @@ namespace mmix {
 				 * Constructor
 				 * @param macro name of the macro that caused the exception
 				 */
-				explicit UnknownMacroException(std::string& macro) : macro_{macro} {
+				explicit UnknownMacroException(const std::string& macro) : macro_{macro} {
 					message_ += "[" + macro + "]";
 				}
 			public:
@@ -365,6 +460,84 @@ namespace mmix {
 					return message_.c_str();
 				}
 			};
+
+			/** 
+			 * The exception is thrown when a file includes itself
+			 * (directly or through other files)
+			 */
+			class IncludeCycleException : public std::exception {
+			protected:
+				std::string chain_;								// The includes which make the cycle
+				std::string message_ = "Include cycle :  ";		// The message to print
+			public:
+				/**
+				 * Constructor
+				 * @param chain the includes which make the cycle (e.g. "a -> b -> a")
+				 */
+				explicit IncludeCycleException(const std::string& chain) : chain_{chain} {
+					message_ += "[" + chain + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
+
+			/** 
+			 * The exception is thrown when the condition of "IF"
+			 * is not a comparison ("NAME==VALUE")
+			 */
+			class WrongConditionException : public std::exception {
+			protected:
+				std::string condition_;							// The condition that caused the exception
+				std::string message_ = "Wrong condition :  ";	// The message to print
+			public:
+				/**
+				 * Constructor
+				 * @param condition the condition that caused the exception
+				 */
+				explicit WrongConditionException(const std::string& condition) : condition_{condition} {
+					message_ += "[" + condition + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
+
+			/** 
+			 * The exception is thrown when "ENDIF" has no branching
+			 * macro to close or a branching macro has no "ENDIF"
+			 */
+			class UnmatchedBranchingException : public std::exception {
+			protected:
+				std::string macro_;									// The macro that caused the exception
+				std::string message_ = "Unmatched branching :  ";	// The message to print
+			public:
+				/**
+				 * Constructor
+				 * @param macro the macro that caused the exception (e.g. "ENDIF")
+				 */
+				explicit UnmatchedBranchingException(const std::string& macro) : macro_{macro} {
+					message_ += "[" + macro + "]";
+				}
+			public:
+				/**
+				 * Get the descriprion of the exception
+				 * @return C-string with a message
+				 */
+				virtual const char* what() const throw() {
+					return message_.c_str();
+				}
+			};
 		} // namespace macroprocessor
 	} // exceptions
 } // mmix
\ No newline at end of file
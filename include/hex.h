@@ -0,0 +1,64 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace mmix {
+	namespace hex {
+		static constexpr size_t digits 		= 16;			// The number of hex digits of an octabyte
+		static constexpr size_t line_size 	= digits + 1;	// The digits and the end of line
+
+		/**
+		 * Write an octabyte as 16 lowercase hex digits (padded with zeros)
+		 * @param value the octabyte to encode
+		 * @param output the buffer for the digits
+		 */
+		void encode(uint64_t value, char* output);
+
+		/**
+		 * Write octabytes as lines of the hex output (16 lowercase digits and '\n').
+		 * Uses AVX2 or SSE2 when the build targets them.
+		 * @param values the octabytes to encode
+		 * @param count the number of octabytes
+		 * @param output the buffer for count * line_size characters
+		 */
+		void encode(const uint64_t* values, size_t count, char* output);
+
+		/**
+		 * An implementation of the encoder of the lines
+		 */
+		struct Path {
+			const char* name;												// The instruction set
+			void 		(*encode)(const uint64_t*, size_t, char*);			// The encoder of the lines
+		};
+
+		/**
+		 * Get the implementations built for the target (so they can be checked
+		 * against each other), the scalar one is the first and the last one
+		 * is used by encode()
+		 * @return the implementations
+		 */
+		std::vector<Path> paths(void);
+	} // namespace hex
+} // namespace mmix
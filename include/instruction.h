@@ -20,33 +20,110 @@
 #pragma once
 
 // Include C++ STL headers
-#include <string>
-#include <vector>
+#include <string_view>
 #include <iostream>
-#include <memory>
+#include <cstdint>
+
+// Include project headers
+#include "arena.h"
+#include "symbols.h"
 
 namespace mmix {
+	/**
+	 * An operand of an instruction. Identifiers are interned
+	 * when the line is parsed, so labels are resolved by their
+	 * IDs, and a resolved operand carries its value instead
+	 * of the text.
+	 */
+	struct Operand {
+		/**
+		 * Types of operands
+		 */
+		enum Type : uint8_t {
+			SYMBOL = 0,
+			REGISTER,
+			IMMEDIATE,
+			STRING,
+			EXPRESSION
+		};
+
+		Type 				type{Type::EXPRESSION};
+		bool 				resolved{false};			// The value is known
+		symbols::Id 		symbol{symbols::none};		// The ID of a symbol
+		uint64_t 			value{0};					// The value of a resolved operand
+		std::string_view 	text;						// The original text
+
+		/**
+		 * Create a resolved operand
+		 * @param value_ the value of the operand
+		 * @return the operand
+		 */
+		static Operand constant(uint64_t value_) {
+			Operand operand;
+			operand.type 		= Type::IMMEDIATE;
+			operand.resolved 	= true;
+			operand.value 		= value_;
+			return operand;
+		}
+	};
+
+	/**
+	 * Write the operand into a stream
+	 * @param stream the output stream
+	 * @param operand the operand to write
+	 * @return the stream
+	 */
+	inline std::ostream& operator<<(std::ostream& stream, const Operand& operand) {
+		if (operand.text.empty() and operand.resolved) return stream << operand.value;
+		return stream << operand.text;
+	}
+
 	/**
 	 * The main structure in the program. It is used
 	 * to store the complete information about the
-	 * instruction. It is filled in Parser class
+	 * instruction. It is filled in Parser class. Instructions
+	 * and their strings are stored in an Arena.
+	 *
+	 * The structures are not polymorphic, the concrete type
+	 * is stored in the "kind" field, so passes dispatch on a
+	 * single byte instead of dynamic casts.
 	 */
 	struct Instruction {
-		using Parameters = std::vector<std::string>;
+		using Parameters = Span<Operand>;
+
+		/**
+		 * Concrete types of instructions
+		 */
+		enum Kind : uint8_t {
+			MNEMONIC = 0,
+			MACRO,
+			ALLOCATOR,
+			DIRECTIVE
+		};
 
-		std::string label;
-		Parameters	parameters;
+		Kind 				kind;
+		std::string_view 	label;
+		symbols::Id 		symbol{symbols::none};		// The ID of the label
+		Parameters			parameters;
 
 		/**
-		 * Destructor
+		 * Constructor
+		 * @param kind_ the concrete type of the instruction
 		 */
-		virtual ~Instruction() = default;
+		explicit Instruction(Kind kind_) : kind{kind_} {}
 
 		/**
 		 * Write the object into a stream
 		 * @param stream the output stream to put the data into
 		 */
-		virtual void write(std::ostream& stream) const noexcept = 0;
+		void write(std::ostream& stream) const noexcept;
+
+		/**
+		 * Copy the object into an arena
+		 * @param arena the arena to store the copy in
+		 * @return the copy
+		 */
+		Instruction* clone(Arena& arena) const;
 	};
 
 	/**
@@ -54,27 +131,51 @@ namespace mmix {
 	 * compiler is stored in the structure
 	 */
 	struct Mnemonic : Instruction {
-		std::string mnemonic;
+		std::string_view mnemonic;
+
+		/**
+		 * Constructor
+		 */
+		Mnemonic(void) : Instruction{Kind::MNEMONIC} {}
 
 		/**
 		 * Write the object into a stream
 		 * @param stream the output stream to put the data into
 		 */
 		void write(std::ostream& stream) const noexcept;
+
+		/**
+		 * Copy the object into an arena
+		 * @param arena the arena to store the copy in
+		 * @return the copy
+		 */
+		Mnemonic* clone(Arena& arena) const;
 	};
 
 	/**
 	 * Macro data is stored in the structure
 	 */
 	struct Macro : Instruction {
-		std::string 					type;
-		std::shared_ptr<Instruction> 	expression;
+		std::string_view 	type;
+		Instruction* 		expression{nullptr};
+
+		/**
+		 * Constructor
+		 */
+		Macro(void) : Instruction{Kind::MACRO} {}
 
 		/**
 		 * Write the object into a stream
 		 * @param stream the output stream to put the data into
 		 */
 		void write(std::ostream& stream) const noexcept;
+
+		/**
+		 * Copy the object into an arena
+		 * @param arena the arena to store the copy in
+		 * @return the copy
+		 */
+		Macro* clone(Arena& arena) const;
 	};
 
 	/**
@@ -82,13 +183,25 @@ namespace mmix {
 	 * memory for data
 	 */
 	struct Allocator : Instruction {
-		std::string size;
+		std::string_view size;
+
+		/**
+		 * Constructor
+		 */
+		Allocator(void) : Instruction{Kind::ALLOCATOR} {}
 
 		/**
 		 * Write the object into a stream
 		 * @param stream the output stream to put the data into
 		 */
 		void write(std::ostream& stream) const noexcept;
+
+		/**
+		 * Copy the object into an arena
+		 * @param arena the arena to store the copy in
+		 * @return the copy
+		 */
+		Allocator* clone(Arena& arena) const;
 	};
 	
 	/**
@@ -96,23 +209,41 @@ namespace mmix {
 	 * contains a directive in it
 	 */
 	struct Directive : Instruction {
-		std::string	directive;
+		std::string_view directive;
+
+		/**
+		 * Constructor
+		 */
+		Directive(void) : Instruction{Kind::DIRECTIVE} {}
 
 		/**
 		 * Write the object into a stream
 		 * @param stream the output stream to put the data into
 		 */
 		void write(std::ostream& stream) const noexcept;
+
+		/**
+		 * Copy the object into an arena
+		 * @param arena the arena to store the copy in
+		 * @return the copy
+		 */
+		Directive* clone(Arena& arena) const;
 	};
 
 	/**
-	 * Factory class for instructions
+	 * Factory class for instructions, the instructions
+	 * are allocated in the given arena
 	 */
 	class InstructionFactory {
+	protected:
+		Arena& arena_;
+
 	public:
-		std::shared_ptr<Macro> create_macro();
-		std::shared_ptr<Mnemonic> create_mnemonic();
-		std::shared_ptr<Allocator> create_allocator();
-		std::shared_ptr<Directive> create_directive();
+		explicit InstructionFactory(Arena& arena) : arena_{arena} {}
+
+		Macro* create_macro();
+		Mnemonic* create_mnemonic();
+		Allocator* create_allocator();
+		Directive* create_directive();
 	};
 } // mmix
\ No newline at end of file
@@ -0,0 +1,129 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <array>
+#include <iterator>
+#include <string_view>
+#include <cstdint>
+
+// Include project headers
+#include "directives.h"
+#include "mnemonics.h"
+#include "macros.h"
+#include "sizes.h"
+
+namespace mmix {
+	namespace keywords {
+		/**
+		 * Types of the keywords
+		 */
+		enum Type : uint8_t {
+			MNEMONIC = 0,
+			DIRECTIVE,
+			MACRO,
+			SIZE
+		};
+
+		/**
+		 * An entry of the keyword table
+		 */
+		struct Keyword {
+			std::string_view 	name;
+			Type 				type;
+			uint32_t 			code;	// The opcode of a mnemonic or the size of data
+		};
+
+		static constexpr size_t count = 
+			std::size(compiler::mnemonics) + 
+			std::size(preprocessor::directives) + 
+			std::size(macroprocessor::macros) + 
+			std::size(compiler::sizes);
+
+		using Table = std::array<Keyword, count>;
+
+		/**
+		 * Merge the tables of mnemonics, directives, macros and sizes
+		 * and sort the result by name (at compile time)
+		 * @return the sorted table
+		 */
+		constexpr Table make_table(void) {
+			Table 	table{};
+			size_t 	index = 0;
+
+			for (const auto& [name, code] : compiler::mnemonics) 
+				table[index++] = Keyword{name, Type::MNEMONIC, code};
+			for (const auto& name : preprocessor::directives) 
+				table[index++] = Keyword{name, Type::DIRECTIVE, 0};
+			for (const auto& name : macroprocessor::macros) 
+				table[index++] = Keyword{name, Type::MACRO, 0};
+			for (const auto& [name, code] : compiler::sizes) 
+				table[index++] = Keyword{name, Type::SIZE, code};
+
+			// Insertion sort (std::sort is not constexpr in C++17)
+			for (size_t current = 1; current < table.size(); ++current) {
+				auto value = table[current];
+				size_t position = current;
+
+				for (; position > 0 and value.name < table[position - 1].name; --position) 
+					table[position] = table[position - 1];
+				table[position] = value;
+			}
+
+			return table;
+		}
+
+		inline constexpr Table table = make_table();
+
+		/**
+		 * Check that every keyword is unique
+		 * @return true if there are no duplicates
+		 */
+		constexpr bool is_unique(void) {
+			for (size_t index = 1; index < table.size(); ++index) 
+				if (table[index - 1].name == table[index].name) return false;
+			return true;
+		}
+
+		static_assert(is_unique(), "Keywords must be unique");
+
+		/**
+		 * Find a keyword in the table. The search is branch-free
+		 * (the only branch is the loop with a fixed number of 
+		 * iterations), so classification of tokens is cheap.
+		 * @param name the name of the keyword
+		 * @return the keyword or nullptr if the name is not a keyword
+		 */
+		constexpr const Keyword* find(std::string_view name) {
+			const Keyword* 	base 	= table.data();
+			size_t 			length 	= table.size();
+
+			// Find the last keyword which is not greater than the name
+			while (length > 1) {
+				size_t half = length / 2;
+				base = (base[half].name <= name) ? base + half : base;
+				length -= half;
+			}
+
+			return (base->name == name) ? base : nullptr;
+		}
+	} // namespace keywords
+} // namespace mmix
@@ -0,0 +1,130 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Include project headers
+#include "keywords.h"
+
+namespace mmix {
+	namespace lexer {
+		/**
+		 * Types of the tokens
+		 */
+		enum TokenType : uint8_t {
+			LABEL = 0,
+			OPCODE,
+			REGISTER,
+			IMMEDIATE,
+			STRING,
+			IDENTIFIER,
+			OPERATOR,
+			SEPARATOR,
+			EXPRESSION
+		};
+
+		/**
+		 * A token is a view into the line it was found in
+		 */
+		struct Token {
+			TokenType 			type;
+			std::string_view 	value;
+		};
+
+		using Tokens = std::vector<Token>;
+	} // namespace lexer
+
+	/**
+	 * The class splits lines of the program into classified
+	 * tokens. Each line is scanned once and the tokens point
+	 * into it, so nothing is copied.
+	 */
+	class Lexer {
+	protected:
+		/**
+		 * Skip spaces and tabs
+		 * @param line the line to scan
+		 * @param position the position to start from
+		 * @return the position of the next non-space character
+		 */
+		static size_t skip_spaces(std::string_view line, size_t position);
+
+		/**
+		 * Scan a word (a label or an opcode)
+		 * @param line the line to scan
+		 * @param position the position to start from
+		 * @return the position after the word
+		 */
+		static size_t scan_word(std::string_view line, size_t position);
+
+		/**
+		 * Scan the operands field into tokens
+		 * @param line the line to scan
+		 * @param position the position to start from
+		 * @param tokens the vector to push the tokens to
+		 * @return the position after the field
+		 */
+		static size_t scan_operands(std::string_view line, size_t position, lexer::Tokens& tokens);
+
+	public:
+		/**
+		 * Check if the word is an opcode (a mnemonic, a directive, a macro or a size)
+		 * @param word the word to check
+		 * @return true if the word is an opcode
+		 */
+		static bool is_opcode(std::string_view word);
+
+		/**
+		 * Get the type of a single operand
+		 * @param operand the operand to classify
+		 * @return the type of the first token of the operand
+		 */
+		static lexer::TokenType classify(std::string_view operand);
+
+		/**
+		 * Decode a numeric operand : a register ("$N"), a hexadecimal ("#FF")
+		 * or a decimal constant (a negative one wraps around). It doesn't
+		 * allocate or throw.
+		 * @param operand the text of the operand
+		 * @param value the decoded value
+		 * @return true if the whole operand is a number
+		 */
+		static bool decode(std::string_view operand, uint64_t& value);
+
+		/**
+		 * Split the line into tokens. A comment line gives no tokens.
+		 * @param line the line to split
+		 * @param tokens the vector to store the tokens in (it's cleared first)
+		 */
+		static void tokenize(std::string_view line, lexer::Tokens& tokens);
+
+		/**
+		 * Split the operands field (or an expression) into tokens
+		 * @param operands the field to split
+		 * @param tokens the vector to store the tokens in (it's cleared first)
+		 */
+		static void tokenize_operands(std::string_view operands, lexer::Tokens& tokens);
+	};
+} // namespace mmix
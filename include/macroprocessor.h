@@ -21,19 +21,25 @@
 
 // Include C++ STL headers
 #include <vector>
+#include <map>
 #include <memory>
 #include <string>
 #include <set>
 #include <tuple>
 #include <functional>
+#include <unordered_map>
+#include <optional>
 
 // Include project headers
 #include "instruction.h"
+#include "arena.h"
+#include "symbols.h"
 #include "parser.h"
+#include "trace.h"
 
 namespace mmix {
 	namespace macroprocessor {
-		using MacroprocessedProgram = std::vector<std::shared_ptr<Instruction>>;
+		using MacroprocessedProgram = std::vector<Instruction*>;
 	} // namespace macroprocessor
 	
 	/**
@@ -47,14 +53,29 @@ namespace mmix {
 		/**
 		 * This is a superclass for all macro structures.
 		 * It holds common fields and is used as a element
-		 * type for containers.
+		 * type for containers. The concrete type is stored
+		 * in the "kind" field.
 		 */
 		struct MacroEntry {
 		public:
-			using Parameters = std::vector<std::string>;
+			using Parameters = Instruction::Parameters;
 
-			Parameters	parameters;
-			std::string label;
+			/**
+			 * Concrete types of macro entries
+			 */
+			enum Kind : uint8_t {
+				ENTRY = 0,
+				USE,
+				EXPRESSION,
+				CONSTANT,
+				INCLUDE,
+				DEFINE_BRANCHING,
+				EXPRESSION_BRANCHING
+			};
+
+			Kind 				kind{Kind::ENTRY};
+			Parameters			parameters;
+			std::string_view 	label;
 
 		public:
 			/**
@@ -67,7 +88,7 @@ namespace mmix {
 			 * @param parameters_ 	macro parameters
 			 * @param label_ 		the label on the macro 
 			 */
-			explicit MacroEntry(std::string label_) : 
+			explicit MacroEntry(std::string_view label_) : 
 				label{label_} {}
 
 			/**
@@ -75,7 +96,7 @@ namespace mmix {
 			 * @param parameters_ 	macro parameters
 			 * @param label_ 		the label on the macro 
 			 */
-			MacroEntry(Parameters parameters_, std::string label_ = "") : 
+			MacroEntry(Parameters parameters_, std::string_view label_ = "") : 
 				parameters{parameters_}, label{label_} {}
 
 			/**
@@ -100,8 +121,8 @@ namespace mmix {
 			 * @param parameters_	macro parameters
 			 * @param offset_		the address of the macro to be expanded
 			 */
-			UseMacro(Parameters parameters_, size_t offset_ = 0, const std::string& label_ = "") : 
-				MacroEntry{parameters_, label_}, offset{offset_} {}
+			UseMacro(Parameters parameters_, size_t offset_ = 0, std::string_view label_ = "") : 
+				MacroEntry{parameters_, label_}, offset{offset_} { kind = Kind::USE; }
 
 		};
 
@@ -114,7 +135,7 @@ namespace mmix {
 		public:
 			using Expression = Instruction;
 
-			std::shared_ptr<Expression>	expression;
+			Expression*	expression;
 
 		public:
 			/**
@@ -123,10 +144,10 @@ namespace mmix {
 			 * @param expression_	the expression which is to be changed
 			 * @param parameters_	macro parameters
 			 */
-			MacroExpression(const std::string& label_, std::shared_ptr<Expression> expression_, 
+			MacroExpression(std::string_view label_, Expression* expression_, 
 							Parameters parameters_) :
 							MacroEntry{parameters_,label_}, expression{expression_}
-							{}
+							{ kind = Kind::EXPRESSION; }
 		};
 
 		/**
@@ -136,7 +157,7 @@ namespace mmix {
 		 */
 		struct ConstantMacro : MacroEntry {
 		public:
-			std::string value;
+			std::string_view value;
 
 		public:
 			/**
@@ -144,9 +165,9 @@ namespace mmix {
 			 * @param l the label
 			 * @param v the constant expression
 			 */
-			ConstantMacro(const std::string& label_,
-				const std::string& value_) : 
-				MacroEntry{label_}, value{value_} {}
+			ConstantMacro(std::string_view label_,
+				std::string_view value_) : 
+				MacroEntry{label_}, value{value_} { kind = Kind::CONSTANT; }
 
 		private:
 			using MacroEntry::Parameters;
@@ -161,14 +182,14 @@ namespace mmix {
 		 */
 		struct IncludeMacro : MacroEntry {
 		public:
-			std::string filename;
+			std::string_view filename;
 
 		public:
 			/**
 			 * Constructor
 			 * @param filename_ the name of the file to include
 			 */
-			IncludeMacro(const std::string& filename_) : filename{filename_} {}
+			IncludeMacro(std::string_view filename_) : filename{filename_} { kind = Kind::INCLUDE; }
 
 		private:
 			using MacroEntry::Parameters;
@@ -181,14 +202,14 @@ namespace mmix {
 		 */
 		struct IBranchingMacro : MacroEntry {
 		public:
-			std::string expression;		// The expression to check
+			std::string_view expression;		// The expression to check
 		
 		public:
 			/**
 			 * Constructor
 			 * @param expr the expression to analyze
 			 */
-			IBranchingMacro(const std::string& expr) : 
+			IBranchingMacro(std::string_view expr) : 
 				expression{expr} {}
 
 			/**
@@ -196,13 +217,23 @@ namespace mmix {
 			 */
 			virtual ~IBranchingMacro() {}
 
+			/**
+			 * Check if the entry is a branching macro
+			 * @param entry the entry to check
+			 * @return true if the entry is derived from IBranchingMacro
+			 */
+			static bool is_branching(const MacroEntry& entry) {
+				return entry.kind == Kind::DEFINE_BRANCHING or 
+					entry.kind == Kind::EXPRESSION_BRANCHING;
+			}
+
 		public:
 			/**
 			 * Start the block
 			 * @param t the type of the block
 			 * @param addr the address
 			 */
-			virtual void start(const std::string& t, size_t addr) = 0;
+			virtual void start(std::string_view t, size_t addr) = 0;
 
 			/**
 			 * End a block
@@ -230,9 +261,10 @@ namespace mmix {
 			};
 
 		public:
-			Type 	type;
-			size_t 	start_offset;
-			size_t 	end_offset;
+			Type 		type{Type::DEF};
+			symbols::Id symbol{symbols::none};		// The interned expression
+			size_t 		start_offset{0};
+			size_t 		end_offset{0};
 
 		public:
 			/**
@@ -241,10 +273,11 @@ namespace mmix {
 			 * @param addr the address of the start
 			 * @param t the type of the macro
 			 */
-			DefineBranchingMacro(const std::string& expr, 
+			DefineBranchingMacro(std::string_view expr, 
 				size_t addr, 
-				const std::string& t) : 
+				std::string_view t) : 
 				IBranchingMacro{expr} {
+					kind = Kind::DEFINE_BRANCHING;
 					start(t, addr);
 				}
 
@@ -254,7 +287,7 @@ namespace mmix {
 			 * @param t the type of the block
 			 * @param addr the address
 			 */
-			void start(const std::string& t, size_t addr) override {
+			void start(std::string_view t, size_t addr) override {
 				// Set the type
 				if (t == "IFDEF") type = Type::DEF;
 				else if (t == "IFNDEF") type = Type::NDEF;
@@ -282,8 +315,8 @@ namespace mmix {
 			 * A block of data to paste/remove
 			 */
 			struct Block {
-				size_t 	start;	// Start of the block
-				size_t 	end;	// End of the block
+				size_t 	start{0};	// Start of the block
+				size_t 	end{0};		// End of the block
 			};	
 
 		public:
@@ -297,8 +330,11 @@ namespace mmix {
 			 * @param expr the expression to analyze
 			 */
 			// FIXME : hardcodded value
-			ExprBranchingMacro(const std::string& expr, size_t addr) :
-				IBranchingMacro{expr} { start("IF", addr); }
+			ExprBranchingMacro(std::string_view expr, size_t addr) :
+				IBranchingMacro{expr} { 
+					kind = Kind::EXPRESSION_BRANCHING;
+					start("IF", addr); 
+				}
 
 		public:
 			/**
@@ -306,7 +342,7 @@ namespace mmix {
 			 * @param t the type of the block
 			 * @param addr the address
 			 */
-			void start(const std::string& t, size_t addr) override {
+			void start(std::string_view t, size_t addr) override {
 				if (t == "IF") if_block.start = addr;
 				else if (t == "ELSE") {
 					if_block.end = addr - 1;
@@ -325,27 +361,66 @@ namespace mmix {
 		};
 
 		using MacroEntries	= std::vector<std::shared_ptr<MacroEntry>>;
-		using MacroTable 	= std::map<std::string, MacroEntries>;
+		using MacroLabels 	= std::unordered_map<symbols::Id, std::shared_ptr<MacroEntry>>;
+
+		using FileId 		= uint32_t;								// The index of a file in the table
+
+		/**
+		 * The state of a file in the include graph
+		 */
+		enum Inclusion : uint8_t {
+			UNVISITED = 0,		// The file wasn't reached yet
+			VISITING,			// The includes of the file are being processed
+			INCLUDED			// The file is in the program
+		};
+
+		/**
+		 * A source file with its macros
+		 */
+		struct File {
+			std::string 							name;		// The name of the file
+			std::shared_ptr<parser::ParsedFile> 	content;	// The instructions of the file
+			MacroEntries 							entries;	// The macros in the order of the file
+			MacroLabels 							labels;		// The labeled macros by their interned names
+			std::vector<FileId> 					includes;	// The included files in the order of the file
+			Inclusion 								state;		// The state in the include graph
+		};
+
+		using MacroTable 	= std::vector<File>;
+		using FileIds 		= std::unordered_map<std::string, FileId>;
 
 	protected:
-		std::shared_ptr<parser::ParsedProgram> 					sources_;		// The sources of the program
 		std::shared_ptr<macroprocessor::MacroprocessedProgram>	program_;		// The result of processing macros
-		std::shared_ptr<MacroTable> 							macro_table_;	// The table of macro's to process
+		std::shared_ptr<MacroTable> 							macro_table_;	// The files and their macros
+		FileIds 												file_ids_;		// The IDs of the files by their names
+		std::vector<std::shared_ptr<IBranchingMacro>> 			branches_;		// The open branching macros of the file
+		std::shared_ptr<Arena> 									arena_;			// The storage of the instructions
+		std::shared_ptr<SymbolTable> 							symbols_;		// The interned identifiers
 
 	protected:
 		/**
-		 * Fill the macro table with data
+		 * Fill the macro table with data and remove the macros from the
+		 * files (the uses of the macros keep their places)
 		 */
 		virtual void fill_tables(void);
 
 		/**
-		 * Include files to the given file
-		 * @param target_filename the file to which include other files
+		 * Build the program from the main file and the files it includes.
+		 * Every file is included once, even if several files include it.
+		 * @param main the main file
+		 */
+		void include_files(FileId main);
+
+		/**
+		 * Put a file after the files it includes into the program
+		 * (the files which are already in the program are skipped)
+		 * @param file the file to include
+		 * @param chain the files being included (to report a cycle)
 		 */
-		void include_files(const std::string& target_filename);
+		void include_file(FileId file, std::vector<FileId>& chain);
 
 		/**
-		 * Replace all the macros with actual data
+		 * Replace the uses of the macros with the expanded instructions
 		 */
 		void replace_macros(void);
 
@@ -356,68 +431,87 @@ namespace mmix {
 
 		/**
 		 * Clear positions of the file
-		 * @param filename the file to lookup instructions in
+		 * @param file the file to lookup instructions in
 		 * @param start the starting position
 		 * @param end the ending position (excluded)
 		 */
-		void clear(const std::string& filename, size_t start, size_t end);
+		void clear(FileId file, size_t start, size_t end);
 
 		/**
 		 * Check if the expression existst
-		 * @param filename the file to lookup expression in
-		 * @param expr the expression to check
+		 * @param file the file to lookup expression in
+		 * @param expr the interned expression to check
 		 * @return true if there is such an expression
 		 */
-		bool exists(const std::string& filename, const std::string& expr);
+		bool exists(FileId file, symbols::Id expr);
 
 		/**
 		 * Check if the expression is logically correct
-		 * @param filename the file to lookup expression in
+		 * @param file the file to lookup expression in
 		 * @param expr the expression to check
 		 * @return true if the expression is correct (e.g. VALUE == true)
 		 */
-		bool check(const std::string& filename, const std::string& expr);
+		bool check(FileId file, std::string_view expr);
 
 		/**
-		 * 
-		 * @param filename the file to check
+		 * Get the content of a file
+		 * @param file the file to check
 		 * @return the content
 		 */
-		std::shared_ptr<mmix::parser::ParsedFile> get_content(const std::string& filename);
+		std::shared_ptr<mmix::parser::ParsedFile> get_content(FileId file);
+
+		/**
+		 * Find the ID of a file
+		 * @param filename the name of the file
+		 * @return the ID of the file
+		 */
+		FileId find_file(std::string_view filename) const;
+
+		/**
+		 * Get the interned name of an operand
+		 * @param operand the operand
+		 * @return the ID of the name (symbols::none if it was never interned)
+		 */
+		symbols::Id identify(const Operand& operand) const;
 
 		/**
 		 * Expand a macro into an actual instruction
 		 * @param value 	data for macro expanding
-		 * @param filename 	the file where the instruction residents
+		 * @param file 		the file where the instruction residents
 		 * @return 			the instruction from the expanded macro
 		 */
-		std::shared_ptr<Instruction> expand_macro(std::shared_ptr<UseMacro>& value, const std::string& filename);
+		Instruction* expand_macro(std::shared_ptr<UseMacro>& value, FileId file);
 
 		/**
 		 * Extract data from the macro and differentiate macro types
 		 * @param value 	the macro to process
 		 * @param offset 	macro's offset in the memory
+		 * @param file 		the file of the macro
 		 * @return 			a macro with a specific type
 		 */
 		std::shared_ptr<MacroEntry> 
-		process_macro(const std::shared_ptr<Macro>& value, 
+		process_macro(const Macro* value, 
 			size_t offset, 
-			const std::string& filename);
+			FileId file);
 
 		/**
 		 * Find a macro with a given label
-		 * @param label 	macro's label
-		 * @param filename 	the name of the file where the macro is stored
+		 * @param label 	the label of the macro
+		 * @param file 		the file where the macro is stored
 		 * @return 			the macro (if it exists)
 		 */
-		std::shared_ptr<MacroEntry> find_label(const std::string& label, const std::string& filename);
+		std::shared_ptr<MacroEntry> find_label(const Operand& label, FileId file);
 
 	public:
 		/**
 		 * Constructor
 		 * @param sources the source files of the 
+		 * @param arena the storage for the expanded instructions
+		 * @param symbols the table to intern the expanded identifiers into
 		 */
-		Macroprocessor(std::shared_ptr<parser::ParsedProgram> program);
+		Macroprocessor(std::shared_ptr<parser::ParsedProgram> program, 
+			std::shared_ptr<Arena> arena, 
+			std::shared_ptr<SymbolTable> symbols);
 
 	public:
 		/**
@@ -20,12 +20,11 @@
 #pragma once
 
 // Include C++ STL headers
-#include <vector>
-#include <string>
+#include <string_view>
 
 namespace mmix {
 	namespace macroprocessor {
-		static const std::vector<std::string> macros {
+		inline constexpr std::string_view macros[] {
 			"INCLUDE",
 			"MACRO",
 			"USEMACRO",
@@ -0,0 +1,162 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <map>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+
+// Include project headers
+#include "constants.h"
+
+namespace mmix {
+	namespace memory {
+		/**
+		 * Sparse memory image. It is stored as a set of
+		 * extents (contiguous runs of values) keyed by the
+		 * address of their first element, so only the
+		 * emitted values take memory and "LOC" is a single
+		 * lookup in the table of extents.
+		 */
+		template <typename T>
+		class Image {
+		public:
+			using Extent 			= std::vector<T>;
+			using Extents 			= std::map<uint64_t, Extent>;
+			using const_iterator 	= typename Extents::const_iterator;
+
+		protected:
+			Extents 					extents_;						// Extents of the image
+			typename Extents::iterator 	current_;						// The extent the values are written to
+			uint64_t 					address_{constants::text_segment};	// The address of the next value
+
+		public:
+			/**
+			 * Constructor
+			 */
+			Image(void) {
+				current_ = extents_.emplace(address_, Extent()).first;
+			}
+
+			/**
+			 * Copy constructor
+			 * @param other the image to copy
+			 */
+			Image(const Image& other) :
+				extents_{other.extents_},
+				address_{other.address_} {
+				current_ = std::prev(extents_.upper_bound(address_));
+			}
+
+			/**
+			 * Assignment is not supported, the current extent can't be shared
+			 */
+			Image& operator=(const Image& other) = delete;
+
+			/**
+			 * Set the address of the next value (used with "LOC")
+			 * @param address the new address
+			 */
+			void locate(uint64_t address) {
+				// Don't keep extents without data
+				if (current_->second.empty()) extents_.erase(current_);
+				address_ = address;
+
+				// Continue an extent which contains the address or ends right before it
+				auto iterator = extents_.upper_bound(address);
+				if (iterator != extents_.begin()) {
+					auto previous = std::prev(iterator);
+					if (address - previous->first <= previous->second.size()) {
+						current_ = previous;
+						return;
+					}
+				}
+
+				// Start a new extent otherwise
+				current_ = extents_.emplace_hint(iterator, address, Extent());
+			}
+
+			/**
+			 * Write the value at the current address and move to the next one
+			 * @param value the value to write
+			 */
+			void push_back(const T& value) {
+				auto& [origin, extent] 	= *current_;
+				auto index 				= address_ - origin;
+
+				// Overwrite the value if the address was already used
+				if (index < extent.size()) extent[index] = value;
+				else extent.push_back(value);
+
+				++address_;
+			}
+
+			/**
+			 * Get the value at the address
+			 * @param address the address of an existing value
+			 * @return reference to the value
+			 */
+			T& at(uint64_t address) {
+				auto iterator = extents_.upper_bound(address);
+				if (iterator == extents_.begin()) throw std::out_of_range("The address is not in the image");
+
+				auto& [origin, extent] = *std::prev(iterator);
+				return extent.at(address - origin);
+			}
+
+			/**
+			 * Get the address of the next value
+			 * @return the address
+			 */
+			uint64_t address(void) const {
+				return address_;
+			}
+
+			/**
+			 * Get the number of values stored in the image
+			 * @return the number of values
+			 */
+			size_t size(void) const {
+				size_t result = 0;
+				for (const auto& [origin, extent] : extents_) result += extent.size();
+				return result;
+			}
+
+			/**
+			 * Get the first extent of the image
+			 * @return iterator to the first extent
+			 */
+			const_iterator begin(void) const {
+				return extents_.begin();
+			}
+
+			/**
+			 * Get the end of the extents table
+			 * @return iterator past the last extent
+			 */
+			const_iterator end(void) const {
+				return extents_.end();
+			}
+		};
+	} // namespace memory
+} // namespace mmix
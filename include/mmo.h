@@ -0,0 +1,127 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+// Include project headers
+#include "constants.h"
+#include "compiler.h"
+
+namespace mmix {
+	namespace mmo {
+		using Buffer = std::vector<char>;
+
+		static const uint8_t escape = 0x98;		// The first byte of every loader instruction
+
+		/**
+		 * Loader instructions of the MMO format
+		 */
+		enum Lopcode {
+			QUOTE = 0x0,
+			LOC,
+			SKIP,
+			FIXO,
+			FIXR,
+			FIXRX,
+			FILE,
+			LINE,
+			SPEC,
+			PRE,
+			POST,
+			STAB,
+			END
+		};
+
+		static const uint8_t version 		= 1;		// Version of the format written to "lop_pre"
+		static const uint8_t last_global 	= 255;		// The first (and the only) initialized global register
+	} // namespace mmo
+
+	/**
+	 * The class converts a compiled program into Knuth's binary
+	 * MMO object format. The whole object is built in a single
+	 * buffer, so it can be written with one call.
+	 */
+	class ObjectWriter {
+	protected:
+		std::shared_ptr<compiler::CompiledProgram> 	program_;	// The program to convert
+		std::shared_ptr<mmo::Buffer> 				buffer_;	// The object file
+		uint64_t 									entry_;		// The address of "Main"
+
+	protected:
+		/**
+		 * Append a big-endian tetrabyte to the object
+		 * @param value the value to append
+		 */
+		void tetra(uint32_t value);
+
+		/**
+		 * Append a loader instruction to the object
+		 * @param lopcode the type of the instruction
+		 * @param y the first operand
+		 * @param z the second operand
+		 */
+		void lop(mmo::Lopcode lopcode, uint8_t y, uint8_t z);
+
+		/**
+		 * Append a tetrabyte of data (quoted if it looks like a loader instruction)
+		 * @param value the data to append
+		 */
+		void data(uint32_t value);
+
+		/**
+		 * Write the preamble of the object
+		 */
+		void write_preamble(void);
+
+		/**
+		 * Write the extents of the program
+		 */
+		void write_program(void);
+
+		/**
+		 * Write the postamble and the symbol table of the object
+		 */
+		void write_postamble(void);
+
+		/**
+		 * Write the symbol table with the only symbol ":Main"
+		 */
+		void write_symbols(void);
+
+	public:
+		/**
+		 * Constructor
+		 * @param program the program to convert
+		 * @param entry the address of "Main"
+		 */
+		ObjectWriter(std::shared_ptr<compiler::CompiledProgram> program, uint64_t entry);
+
+		/**
+		 * Get the object file
+		 * @return the buffer with the object
+		 */
+		std::shared_ptr<mmo::Buffer> get(void);
+	};
+} // namespace mmix
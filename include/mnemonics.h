@@ -20,12 +20,13 @@
 #pragma once
 
 // Include C++ STL headers
-#include <map>
-#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
 
 namespace mmix {
 	namespace compiler {
-		static const std::map<std::string, uint32_t> mnemonics {
+		inline constexpr std::pair<std::string_view, uint32_t> mnemonics[] {
 			{"ADD",0x20},
 			{"ADDI",0x21},
 			{"ADDU",0x22},
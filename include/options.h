@@ -0,0 +1,69 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include Boost headers
+#include <boost/program_options.hpp>
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <memory>
+
+// Include project headers
+#include "application.h"
+
+namespace mmix {
+	namespace options {
+		/**
+		 * Describe the options of a build
+		 * @return the description of the options
+		 */
+		boost::program_options::options_description describe(void);
+
+		/**
+		 * Parse the arguments of a build
+		 * @param arguments the arguments (without the name of the program)
+		 * @param description the description of the options
+		 * @return the values of the options
+		 */
+		boost::program_options::variables_map parse(const std::vector<std::string>& arguments, 
+			const boost::program_options::options_description& description);
+
+		/**
+		 * Create the application from the values of the options
+		 * @param values the values of the options
+		 * @return the configured application
+		 */
+		std::shared_ptr<Application> configure(const boost::program_options::variables_map& values);
+
+		/**
+		 * Create the application for the files from the values of the options
+		 * (the input and output options are ignored)
+		 * @param values the values of the options
+		 * @param inputs the input files
+		 * @param output the output file
+		 * @return the configured application
+		 */
+		std::shared_ptr<Application> configure(const boost::program_options::variables_map& values, 
+			const std::vector<std::string>& inputs, 
+			const std::string& output);
+	} // namespace options
+} // namespace mmix
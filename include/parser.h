@@ -21,7 +21,9 @@
 
 // Include C++ STL headers
 #include <vector>
+#include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <functional>
 #include <algorithm>
@@ -32,17 +34,21 @@
 
 // Include project headers
 #include "instruction.h"
-#include "directives.h"
-#include "mnemonics.h"
-#include "macros.h"
-#include "sizes.h"
+#include "arena.h"
+#include "symbols.h"
+#include "source.h"
+#include "pool.h"
+#include "cache.h"
+#include "trace.h"
+#include "lexer.h"
+#include "keywords.h"
 #include "exceptions.h"
 
 namespace mmix {
 	namespace parser {
-		using RawFile		= std::vector<std::string>;
+		using RawFile		= SourceFile;
 		using RawProgram 	= std::map<std::string, std::shared_ptr<RawFile>>;
-		using ParsedFile	= std::vector<std::shared_ptr<Instruction>>;
+		using ParsedFile	= std::vector<Instruction*>;
 		using ParsedProgram	= std::map<std::pair<std::string, bool>, std::shared_ptr<ParsedFile>>;
 	}
 
@@ -52,44 +58,68 @@ namespace mmix {
 	 */
 	class Parser {
 	protected : 
-		using SplittedLine = std::vector<std::string>;		
-
 		std::shared_ptr<parser::RawProgram> 	raw_;		// The raw strings of the program
-		std::shared_ptr<parser::ParsedProgram> 	parsed_;	// The parsed version of the program
+		std::shared_ptr<parser::ParsedProgram> 	parsed_;		// The parsed version of the program
+		std::shared_ptr<Arena> 					arena_;			// The storage of the instructions
+		std::shared_ptr<SymbolTable> 			symbols_;		// The interned identifiers
+		size_t 									jobs_;			// The number of threads
+		std::shared_ptr<Cache> 					cache_;			// The cache of parsed files (optional)
+		lexer::Tokens 							tokens_;		// Tokens of the current line
+		std::vector<Operand> 					parameters_;	// Parameters of the current line
 
 	protected :
-		/**
-		 * Remove comments from the line
-		 * @param line the line to clear
-		 * @return a clear line
-		 */
-		std::string remove_comments(std::string line);
-
 		/**
 		 * Fill an Instruction struct using the data from the string
 		 * @param line the line to parse
-		 * @return instruction
+		 * @return instruction (empty for comment lines)
 		 */
-		std::shared_ptr<Instruction> parse_line(std::string line);
+		Instruction* parse_line(std::string_view line);
 
 		/**
 		 * Parse the given program into a vector of structs
 		 */
 		void parse(void);
 
+		/**
+		 * Parse a single file
+		 * @param filename the name of the file
+		 * @param file the lines of the file
+		 */
+		void parse_file(const std::string& filename, const parser::RawFile& file);
+
+		/**
+		 * Parse the files concurrently and merge the results
+		 */
+		void parse_parallel(void);
+
+		/**
+		 * Change the symbol IDs of the instruction
+		 * @param instruction the instruction to change
+		 * @param ids the new IDs indexed by the old ones
+		 */
+		static void remap(Instruction* instruction, const std::vector<symbols::Id>& ids);
+
 		/**
 		 * Create an object of a concrete type
 		 * @param token an unknown token 
 		 * @return a new object
 		 */
-		std::shared_ptr<Instruction> create_instruction(const std::string& token);
+		Instruction* create_instruction(std::string_view token);
 
 	public :
 		/**
 		 * Constructor
 		 * @param program the program to parse
+		 * @param arena the storage for the instructions
+		 * @param symbols the table to intern the identifiers into
+		 * @param jobs the number of threads parsing the files (0 means the number of cores)
+		 * @param cache the cache of parsed files (nullptr disables it)
 		 */
-		Parser(std::shared_ptr<mmix::parser::RawProgram> program);
+		Parser(std::shared_ptr<mmix::parser::RawProgram> program, 
+			std::shared_ptr<Arena> arena, 
+			std::shared_ptr<SymbolTable> symbols, 
+			size_t jobs = 1, 
+			std::shared_ptr<Cache> cache = nullptr);
 
 		/**
 		 * Get the parsed program
@@ -98,13 +128,25 @@ namespace mmix {
 		std::shared_ptr<parser::ParsedProgram> get(void);
 
 		/**
-		 * Split the line into a vector of tokens
-		 * @param line the line to split
-		 * @param delimiter the delimeter to use to split the line
-		 * @param count the last element to be split
-		 * @return the split line
+		 * Create an operand from its tokens, an identifier is interned
+		 * @param text the text of the operand
+		 * @param type the type of the first token
+		 * @param size the number of tokens
+		 * @param symbols the table to intern the identifier into
+		 * @return the operand
+		 */
+		static Operand create_operand(std::string_view text, 
+			lexer::TokenType type, 
+			size_t size, 
+			SymbolTable& symbols);
+
+		/**
+		 * Create an operand from its text, an identifier is interned
+		 * @param text the text of the operand
+		 * @param symbols the table to intern the identifier into
+		 * @return the operand
 		 */
-		static SplittedLine split_line(std::string line, std::string delimiter = " ", uint64_t count = 0);
+		static Operand create_operand(std::string_view text, SymbolTable& symbols);
 
 		/**
 		 * Replace a substring with another
@@ -0,0 +1,120 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+
+namespace mmix {
+	/**
+	 * A fixed set of worker threads with a queue of tasks per worker.
+	 * A worker runs its own tasks in the order of submission and steals
+	 * the latest tasks of the other workers when its queue is empty, so
+	 * long tasks don't keep the short ones waiting behind them. The
+	 * results (and the exceptions) of the tasks are returned through
+	 * futures.
+	 */
+	class ThreadPool {
+	protected:
+		/**
+		 * The tasks of a worker
+		 */
+		struct Queue {
+			std::deque<std::function<void()>> 	tasks;		// Tasks waiting for a worker
+			std::mutex 							mutex;		// Guards the tasks
+		};
+
+		std::vector<std::thread> 				workers_;			// Worker threads
+		std::vector<std::unique_ptr<Queue>> 	queues_;			// Tasks of every worker
+		std::atomic<size_t> 					next_{0};			// The queue of the next task from outside
+		std::mutex 								mutex_;				// Guards the number of pending tasks
+		std::condition_variable 				condition_;			// Wakes the workers up
+		size_t 									pending_{0};		// Queued tasks which weren't taken by a worker
+		bool 									stopped_{false};	// The pool is being destroyed
+
+	protected:
+		/**
+		 * Run the tasks until the pool is destroyed
+		 * @param index the index of the worker
+		 */
+		void work(size_t index);
+
+		/**
+		 * Take a task from the own queue or steal it from the others
+		 * (a task must be reserved by the worker)
+		 * @param index the index of the worker
+		 * @return the task
+		 */
+		std::function<void()> take(size_t index);
+
+		/**
+		 * Queue a task
+		 * @param task the task
+		 */
+		void push(std::function<void()> task);
+
+	public:
+		/**
+		 * Constructor
+		 * @param size the number of workers (0 means the number of cores)
+		 */
+		explicit ThreadPool(size_t size);
+
+		/**
+		 * Destructor. The queued tasks are finished first.
+		 */
+		~ThreadPool(void);
+
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+
+		/**
+		 * Queue a task. A task submitted by a worker goes to its own queue.
+		 * @param task the function to call
+		 * @return the future result of the task
+		 */
+		template <typename Task>
+		std::future<std::invoke_result_t<Task>> submit(Task task) {
+			using Result = std::invoke_result_t<Task>;
+
+			auto packaged 	= std::make_shared<std::packaged_task<Result()>>(std::move(task));
+			auto result 	= packaged->get_future();
+			push([packaged]() { (*packaged)(); });
+
+			return result;
+		}
+
+		/**
+		 * Get the number of workers
+		 * @return the number of workers
+		 */
+		size_t size(void) const;
+	};
+} // namespace mmix
@@ -25,18 +25,40 @@
 #include <string>
 #include <memory>
 #include <stack>
+#include <unordered_map>
+#include <limits>
 #include <cstdint>
 
 // Include project headers
 #include "instruction.h"
-#include "mnemonics.h"
+#include "arena.h"
+#include "symbols.h"
+#include "keywords.h"
 #include "exceptions.h"
 #include "constants.h"
+#include "memory.h"
 #include "macroprocessor.h"
+#include "queue.h"
+#include "trace.h"
 
 namespace mmix {
 	namespace preprocessor {
-		using PreprocessedProgram = std::vector<std::shared_ptr<Instruction>>;
+		using PreprocessedProgram = memory::Image<Instruction*>;
+
+		static constexpr size_t chunk_size 		= 4096;		// The maximum number of instructions in a chunk
+		static constexpr size_t stream_capacity = 16;		// The number of chunks waiting for the compiler
+
+		/**
+		 * Instructions placed one after another into the image. The
+		 * chunks of a stream come in the order of the extents.
+		 */
+		struct Chunk {
+			uint64_t 					origin{constants::text_segment};	// The address of the first instruction
+			bool 						extent{false};						// The chunk starts a new extent
+			std::vector<Instruction*> 	instructions;						// The instructions
+		};
+
+		using Stream = BoundedQueue<Chunk>;
 	} // namespace preprocessor
 
 	/**
@@ -46,77 +68,111 @@ namespace mmix {
 	class Preprocessor {
 	private:
 		/**
-	 	 * The strucure holds info about program blocks
+	 	 * The strucure holds info about program blocks. The addresses
+	 	 * are the positions in the program without the directives.
 	 	 */
 		struct Block {
 			std::string label;
-			uint64_t 	origin;
-			uint64_t 	start;
-			uint64_t 	end;
+			uint64_t 	origin{0};				// The instructions of the block are moved before this one
+			uint64_t 	start{0};				// The first instruction of the block
+			uint64_t 	end{0};					// The last instruction of the block
+			uint32_t 	parent{0};				// The block the origin is in (no_block for the program)
+			bool 		opened{false};			// Set if "BLOCK" was found
+			bool 		closed{false};			// Set if "ENDBLOCK" was found
 		};
-		using BlockTable = std::vector<Block>;
+		using BlockTable 	= std::vector<Block>;
+		using BlockIds 		= std::unordered_map<std::string, uint32_t>;
+
+		static constexpr uint32_t no_block = std::numeric_limits<uint32_t>::max();	// Not a block
 
 		std::shared_ptr<BlockTable> block_table_;			// Table of found blocks
+		BlockIds 					block_ids_;				// The indices of the blocks by their names
 
 	private :
 		/**
-		 * Create a new block with given address and name
+		 * Find a block with a given name or create it
 		 * @param label the name of the block
-		 * @param address address of the block
+		 * @param address the origin of a new block
+		 * @param parent the block the origin of a new block is in
+		 * @return the index of the block with the name
 		 */
-		void create_block(std::string label, uint64_t address);
+		uint32_t create_block(std::string_view label, uint64_t address, uint32_t parent);
 
 		/**
-		 * Find a block with a given name
-		 * @param label
-		 * @return a block with the name
+		 * Get the innermost block being defined
+		 * @param open the blocks between "BLOCK" and "ENDBLOCK"
+		 * @return the index of the block (no_block if there is none)
 		 */
-		Block& find_block(std::string& label);
+		static uint32_t parent(const std::vector<uint32_t>& open) {
+			return open.empty() ? no_block : open.back();
+		}
 
 		/**
-		 * Update addresses inside of the block
-		 * @param block the block to update
+		 * Find a block with a given name
+		 * @param label
+		 * @return a block with the name
 		 */
-		void update_block_addresses(Block& block);
+		Block& find_block(std::string_view label);
 
 		/**
-		 * Move the block to it's place
-		 * @param block the block to move
+		 * Move every block to its origin. The new order of the
+		 * instructions is computed from the ranges of the blocks
+		 * and the program is rebuilt once.
 		 */
-		void emplace_block(Block& block);
+		void relocate_blocks(void);
 
 	protected :
-		using Label 		= std::pair<const std::string, std::string>;
-		using LabelTable 	= std::map<std::string, std::string>;
+		using Label 		= const Operand*;
+		using LabelTable 	= std::vector<Label>;		// Expressions indexed by the symbol IDs
 
-		std::shared_ptr<preprocessor::PreprocessedProgram> 	program_;				// The preprocessed program
-		std::shared_ptr<LabelTable>							label_table_;     		// Table of found labels
+		std::shared_ptr<macroprocessor::MacroprocessedProgram> 	program_;				// The program being preprocessed
+		std::shared_ptr<preprocessor::PreprocessedProgram> 		image_;					// The preprocessed program
+		std::shared_ptr<LabelTable>								label_table_;     		// Table of found labels
+		std::shared_ptr<Arena> 									arena_;					// The storage of the instructions
+		std::shared_ptr<SymbolTable> 							symbols_;				// The interned identifiers
+		size_t 													labels_{0};				// The number of label definitions
 
 	protected :
 		/**
 		 * Add a new labeled expression to the list
-		 * @param label a new label
+		 * @param label the ID of a new label
 		 * @param expression the expression to associate with the label
 		 */
-		void create_label(std::string& label, std::string& expression);
+		void create_label(symbols::Id label, const Operand* expression);
 
 		/**
 		 * Find a certain label in the table
-		 * @param label name of table to find
+		 * @param label the ID of the label to find
 		 * @return the found label
 		 */
-		Label& find_label(std::string& label);
+		Label& find_label(symbols::Id label);
 
 		/**
 		 * Replace labels with the expressions from the table
 		 * @param instruction the instruction to process
 		 */
-		void replace_labels(std::shared_ptr<Instruction>& instruction);
+		void replace_labels(Instruction* instruction);
 
 		/**
-		 * Relocate instruction (used with  "LOC")
+		 * Check if the instruction is a relocation ("LOC")
+		 * @param instruction the instruction to check
+		 * @return true if the instruction is "LOC"
 		 */
-		void relocate_instructions(void);
+		static bool is_location(const Instruction* instruction);
+
+		/**
+		 * Get the address of a relocation
+		 * @param operand the operand of "LOC" (with the labels replaced)
+		 * @return the address
+		 */
+		static uint64_t location(const Operand& operand);
+
+		/**
+		 * Replace labels with their expressions and place the instructions 
+		 * into the memory image (relocating them with "LOC")
+		 * @param stream the queue to push the placed instructions to (optional)
+		 */
+		void relocate_instructions(preprocessor::Stream* stream = nullptr);
 
 		/**
 		 * Fill label and block tables with data
@@ -132,13 +188,34 @@ namespace mmix {
 		/**
 		 * Constructor
 		 * @param program the parsed program
+		 * @param arena the storage of the instructions
+		 * @param symbols the interned identifiers of the program
+		 * @param streamed leave the placement of the instructions to "stream"
 		 */
-		Preprocessor(std::shared_ptr<macroprocessor::MacroprocessedProgram> program);
+		Preprocessor(std::shared_ptr<macroprocessor::MacroprocessedProgram> program, 
+			std::shared_ptr<Arena> arena, 
+			std::shared_ptr<SymbolTable> symbols, 
+			bool streamed = false);
+
+		/**
+		 * Place the instructions and push them to the stream as they are 
+		 * placed, the stream is closed at the end (or if it fails). The
+		 * image is complete once the stream is closed.
+		 * @param stream the queue to the compiler
+		 */
+		void stream(preprocessor::Stream& stream);
 
 		/**
 		 * Get the preprocessed program
 		 * @return the program
 		 */
 		std::shared_ptr<preprocessor::PreprocessedProgram> get(void);
+
+		/**
+		 * Get the number of label definitions ("IS" and the labels 
+		 * of the instructions) in the program
+		 * @return the number of labels
+		 */
+		size_t labels(void) const;
 	};
 } // namespace mmix 
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace mmix {
+	/**
+	 * A queue connecting two stages running on different
+	 * threads. The producer waits while the queue is full,
+	 * so a fast stage can't run too far ahead of a slow one.
+	 */
+	template <typename T>
+	class BoundedQueue {
+	protected:
+		std::deque<T> 			items_;				// Items waiting for the consumer
+		size_t 					capacity_;			// The maximum number of items
+		bool 					closed_{false};		// No more items will be pushed
+		std::mutex 				mutex_;				// Guards the queue
+		std::condition_variable not_full_;			// Wakes the producer up
+		std::condition_variable not_empty_;			// Wakes the consumer up
+
+	public:
+		/**
+		 * Constructor
+		 * @param capacity the maximum number of items
+		 */
+		explicit BoundedQueue(size_t capacity) : capacity_{capacity} {}
+
+		/**
+		 * Push an item, waits while the queue is full
+		 * @param item the item to push
+		 * @return false if the queue is closed (the item is dropped)
+		 */
+		bool push(T item) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_full_.wait(lock, [this]() { return closed_ or items_.size() < capacity_; });
+			if (closed_) return false;
+
+			items_.push_back(std::move(item));
+			lock.unlock();
+			not_empty_.notify_one();
+
+			return true;
+		}
+
+		/**
+		 * Pop an item, waits while the queue is empty
+		 * @param item the popped item
+		 * @return false if the queue is closed and empty
+		 */
+		bool pop(T& item) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			not_empty_.wait(lock, [this]() { return closed_ or not items_.empty(); });
+			if (items_.empty()) return false;
+
+			item = std::move(items_.front());
+			items_.pop_front();
+			lock.unlock();
+			not_full_.notify_one();
+
+			return true;
+		}
+
+		/**
+		 * Close the queue, the consumer gets the remaining items
+		 */
+		void close(void) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				closed_ = true;
+			}
+			not_full_.notify_all();
+			not_empty_.notify_all();
+		}
+	};
+} // namespace mmix
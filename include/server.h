@@ -0,0 +1,141 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include Boost headers
+#include <boost/program_options.hpp>
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+
+namespace mmix {
+	namespace server {
+		/**
+		 * A build sent to the server
+		 */
+		struct Request {
+			std::string 										directory;		// The working directory of the build
+			std::vector<std::string> 							arguments;		// The options of the build
+			std::vector<std::pair<std::string, std::string>> 	sources;		// The files given in the memory (name and content)
+		};
+
+		/**
+		 * The result of a build
+		 */
+		struct Response {
+			int32_t 	status{0};		// The exit status (0 if the build succeeded)
+			std::string output;			// The standard output of the build (e.g. the statistics)
+			std::string error;			// The error of the build
+		};
+
+		static constexpr std::string_view shutdown = "--shutdown";	// The argument which stops the server
+		static constexpr uint32_t max_message = 256 * 1024 * 1024;	// The biggest accepted message in bytes
+		static constexpr int 		timeout 	= 10;					// Seconds a client can stall a message
+
+		/**
+		 * Serialize a request. Strings are stored with their length.
+		 * @param request the request
+		 * @return the payload of the message
+		 */
+		std::string encode(const Request& request);
+
+		/**
+		 * Serialize a response
+		 * @param response the response
+		 * @return the payload of the message
+		 */
+		std::string encode(const Response& response);
+
+		/**
+		 * Deserialize a request
+		 * @param data the payload of the message
+		 * @param request the request to fill
+		 * @return false if the payload is broken
+		 */
+		bool decode(std::string_view data, Request& request);
+
+		/**
+		 * Deserialize a response
+		 * @param data the payload of the message
+		 * @param response the response to fill
+		 * @return false if the payload is broken
+		 */
+		bool decode(std::string_view data, Response& response);
+
+		/**
+		 * Send the build to the server and wait for the result
+		 * @param path the path of the socket
+		 * @param request the build
+		 * @return the result of the build
+		 */
+		Response submit(const std::string& path, const Request& request);
+	} // namespace server
+
+	/**
+	 * The build server. It listens on a Unix socket and runs the builds
+	 * one by one in the same process, so the tables of keywords, the
+	 * parsed options and the cache of parsed files stay warm between
+	 * the builds. A message is the length of the payload (a big-endian
+	 * tetrabyte) followed by the payload.
+	 */
+	class Server {
+	protected:
+		std::string 										path_;			// The path of the socket
+		std::string 										cache_;			// The cache of the builds without "--cache-dir"
+		int 												socket_{-1};	// The listening socket
+		boost::program_options::options_description 		description_;	// The options of a build
+
+	protected:
+		/**
+		 * Run a build
+		 * @param request the build
+		 * @return the result of the build
+		 */
+		server::Response handle(const server::Request& request);
+
+	public:
+		/**
+		 * Constructor. A stale socket at the path is replaced.
+		 * @param path the path of the socket
+		 * @param cache the directory of the cache of parsed files (empty disables it)
+		 */
+		explicit Server(const std::string& path, const std::string& cache = "");
+
+		/**
+		 * The socket can't be shared between objects
+		 */
+		Server(const Server& other) = delete;
+		Server& operator=(const Server& other) = delete;
+
+		/**
+		 * Destructor, the socket is removed
+		 */
+		~Server();
+
+		/**
+		 * Serve the builds until a request to shut down
+		 */
+		void run(void);
+	};
+} // namespace mmix
@@ -20,11 +20,13 @@
 #pragma once
 
 // Include C++ STL headers
-#include <map>
-#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+
 namespace mmix {
 	namespace compiler {
-		static const std::map<std::string, uint32_t> sizes {
+		inline constexpr std::pair<std::string_view, uint32_t> sizes[] {
 			{"BYTE", 1},
 			{"WYDE", 2},
 			{"TETRA", 3},
@@ -0,0 +1,120 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace mmix {
+	/**
+	 * Source file of the program. The file is mapped into the
+	 * memory (or refers to a buffer when it's created from the content)
+	 * and its lines are views into the content, so they are valid
+	 * as long as the object and the buffer exist.
+	 */
+	class SourceFile {
+	public:
+		using Lines 			= std::vector<std::string_view>;
+		using const_iterator 	= Lines::const_iterator;
+
+	protected:
+		const char*	data_{nullptr};		// The content of the file
+		size_t 		size_{0};			// The size of the content
+		std::string buffer_;			// The content when the file can't be mapped
+		bool 		mapped_{false};		// Set if the content is a mapping of the file
+		Lines 		lines_;				// Non-empty lines of the file
+
+	protected:
+		/**
+		 * Map the file into the memory
+		 * @param filename the file to map
+		 */
+		void map(const std::string& filename);
+
+		/**
+		 * Split the content into lines
+		 */
+		void split(void);
+
+		/**
+		 * Constructor of an empty file (used by the factories)
+		 */
+		SourceFile(void) = default;
+
+	public:
+		/**
+		 * Constructor
+		 * @param filename the file to read
+		 */
+		explicit SourceFile(const std::string& filename);
+
+		/**
+		 * Create a file from a buffer in the memory
+		 * @param content the content of the file
+		 * @return the file which owns a copy of the content
+		 */
+		static std::shared_ptr<SourceFile> from_content(std::string content);
+
+		/**
+		 * Create a file from a buffer which outlives it (nothing is copied)
+		 * @param content the content of the file
+		 * @return the file which refers to the content
+		 */
+		static std::shared_ptr<SourceFile> from_view(std::string_view content);
+
+		/**
+		 * The mapping can't be shared between objects
+		 */
+		SourceFile(const SourceFile& other) = delete;
+		SourceFile& operator=(const SourceFile& other) = delete;
+
+		/**
+		 * Destructor
+		 */
+		~SourceFile();
+
+		/**
+		 * Get the whole content of the file
+		 * @return the content
+		 */
+		std::string_view content(void) const;
+
+		/**
+		 * Get the first line of the file
+		 * @return iterator to the first line
+		 */
+		const_iterator begin(void) const;
+
+		/**
+		 * Get the end of the lines
+		 * @return iterator past the last line
+		 */
+		const_iterator end(void) const;
+
+		/**
+		 * Get the number of non-empty lines
+		 * @return the number of lines
+		 */
+		size_t size(void) const;
+	};
+} // namespace mmix
@@ -0,0 +1,147 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <utility>
+#include <iostream>
+#include <atomic>
+#include <type_traits>
+#include <cstdint>
+
+namespace mmix {
+	namespace stats {
+		/**
+		 * The number of allocations of the process. The library doesn't
+		 * replace operator new, the executables link "allocations.cpp",
+		 * which increments the counter.
+		 */
+		extern std::atomic<uint64_t> allocations;
+
+		/**
+		 * The number of active users of the counter of allocations,
+		 * the allocations are counted only if there is one
+		 */
+		extern std::atomic<uint32_t> counting;
+
+		/**
+		 * Resource usage of the process at some moment
+		 */
+		struct Usage {
+			double 		wall;			// Wall time in seconds (from an arbitrary point)
+			double 		cpu;			// CPU time of all the threads in seconds
+			uint64_t 	peak_rss;		// Peak resident set size in bytes (0 if it's unknown)
+			uint64_t 	allocations;	// The number of allocations so far
+		};
+
+		/**
+		 * Get the resource usage of the process
+		 * @return the usage
+		 */
+		Usage now(void);
+	} // namespace stats
+
+	/**
+	 * Statistics of an assembly : resources used by every
+	 * stage and the sizes of the program. The CPU time, the
+	 * peak memory and the allocations are of the whole process,
+	 * so they belong to the assembly only if nothing else runs
+	 * in the process at the same time.
+	 */
+	class Statistics {
+	public:
+		/**
+		 * Resources used by a stage
+		 */
+		struct Stage {
+			std::string name;
+			double 		wall;			// Wall time in seconds
+			double 		cpu;			// CPU time in seconds
+			uint64_t 	peak_rss;		// Peak resident set size at the end of the stage
+			uint64_t 	allocations;	// The number of allocations
+		};
+
+	protected:
+		std::vector<Stage> 								stages_;		// Measured stages in the order of execution
+		std::vector<std::pair<std::string, uint64_t>> 	counters_;		// Sizes of the program
+
+	protected:
+		/**
+		 * Save the resources used by a stage
+		 * @param name the name of the stage
+		 * @param start the usage at the start of the stage
+		 */
+		void record(const std::string& name, const stats::Usage& start);
+
+	public:
+		/**
+		 * Constructor. The allocations are counted while the statistics exist.
+		 */
+		Statistics(void);
+
+		/**
+		 * Destructor
+		 */
+		~Statistics();
+
+		/**
+		 * The statistics can't be copied, the copy would stop counting twice
+		 */
+		Statistics(const Statistics& other) = delete;
+		Statistics& operator=(const Statistics& other) = delete;
+
+		/**
+		 * Run a stage and measure it
+		 * @param name the name of the stage
+		 * @param function the stage
+		 * @return the result of the stage
+		 */
+		template <typename Function>
+		auto measure(const std::string& name, Function function) {
+			auto start = stats::now();
+
+			if constexpr (std::is_void_v<std::invoke_result_t<Function>>) {
+				function();
+				record(name, start);
+			}
+			else {
+				auto result = function();
+				record(name, start);
+				return result;
+			}
+		}
+
+		/**
+		 * Save a size of the program
+		 * @param name the name of the counter
+		 * @param value the value
+		 */
+		void count(const std::string& name, uint64_t value);
+
+		/**
+		 * Write the statistics
+		 * @param stream the output stream
+		 * @param json write JSON instead of a table
+		 */
+		void report(std::ostream& stream, bool json) const;
+	};
+} // namespace mmix
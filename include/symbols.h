@@ -0,0 +1,84 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <unordered_map>
+#include <string_view>
+#include <limits>
+#include <cstdint>
+
+// Include project headers
+#include "arena.h"
+
+namespace mmix {
+	namespace symbols {
+		using Id = uint32_t;
+
+		static const Id none = std::numeric_limits<Id>::max();		// No symbol
+	} // namespace symbols
+
+	/**
+	 * Table of interned identifiers. Every distinct name gets
+	 * a dense 32-bit ID when it's met for the first time, so
+	 * the later stages compare and index symbols by integers
+	 * instead of strings. The names are copied into the table.
+	 */
+	class SymbolTable {
+	protected:
+		std::unordered_map<std::string_view, symbols::Id> 	ids_;		// IDs of the names
+		std::vector<std::string_view> 						names_;		// Names of the IDs
+		Arena 												storage_;	// The storage of the names
+
+	public:
+		/**
+		 * Constructor
+		 */
+		SymbolTable(void) = default;
+
+		/**
+		 * Get the ID of the name, a new ID is created for an unknown name
+		 * @param name the name to intern
+		 * @return the ID of the name
+		 */
+		symbols::Id intern(std::string_view name);
+
+		/**
+		 * Get the ID of the name without interning it
+		 * @param name the name to find
+		 * @return the ID of the name (symbols::none if it's unknown)
+		 */
+		symbols::Id find(std::string_view name) const;
+
+		/**
+		 * Get the name of the symbol
+		 * @param id the ID of the symbol
+		 * @return the name
+		 */
+		std::string_view name(symbols::Id id) const;
+
+		/**
+		 * Get the number of interned symbols (all the IDs are less than it)
+		 * @return the number of symbols
+		 */
+		size_t size(void) const;
+	};
+} // namespace mmix
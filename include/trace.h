@@ -0,0 +1,171 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+
+namespace mmix {
+	namespace trace {
+		/**
+		 * Set if the spans are recorded. It's checked by every span,
+		 * so the disabled tracing costs a single load.
+		 */
+		extern std::atomic<bool> active;
+
+		/**
+		 * A completed span of the execution
+		 */
+		struct Event {
+			std::string name;			// The name of the span
+			std::string category;		// The category of the span (usually the stage)
+			std::string detail;			// The subject of the span (a file, a block etc.)
+			double 		start;			// The start time in microseconds
+			double 		duration;		// The duration in microseconds
+			uint32_t 	thread;			// The thread the span ran on
+		};
+
+		/**
+		 * Check if the tracing is enabled
+		 * @return true if the spans are recorded
+		 */
+		inline bool enabled(void) {
+			return active.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Start recording the spans
+		 */
+		void enable(void);
+
+		/**
+		 * Stop recording the spans and drop the recorded ones
+		 */
+		void disable(void);
+
+		/**
+		 * Get the time since the tracing was enabled
+		 * @return the time in microseconds
+		 */
+		double now(void);
+
+		/**
+		 * Get the ID of the current thread, the IDs are small
+		 * numbers given in the order the threads are seen
+		 * @return the ID of the thread
+		 */
+		uint32_t thread(void);
+
+		/**
+		 * Save a completed span (thread-safe)
+		 * @param event the span
+		 */
+		void record(Event event);
+
+		/**
+		 * Write the recorded spans as Chrome trace events, the file
+		 * can be opened in chrome://tracing or Perfetto
+		 * @param stream the output stream
+		 */
+		void write(std::ostream& stream);
+
+		/**
+		 * The span which lasts until the end of the scope. The
+		 * strings aren't copied until the span is recorded, so they
+		 * have to outlive it.
+		 */
+		class Span {
+		protected:
+			std::string_view 	category_;			// The category of the span
+			std::string_view 	name_;				// The name of the span
+			std::string_view 	detail_;			// The subject of the span
+			double 				start_{0};			// The start time in microseconds
+			bool 				active_{false};		// Set if the span is recorded
+
+		public:
+			/**
+			 * Constructor
+			 * @param category the category of the span
+			 * @param name the name of the span
+			 * @param detail the subject of the span
+			 */
+			Span(std::string_view category, std::string_view name, std::string_view detail = {}) {
+				if (not enabled()) return;
+
+				category_ 	= category;
+				name_ 		= name;
+				detail_ 	= detail;
+				start_ 		= now();
+				active_ 	= true;
+			}
+
+			/**
+			 * The spans can't be copied, they would be recorded twice
+			 */
+			Span(const Span& other) = delete;
+			Span& operator=(const Span& other) = delete;
+
+			/**
+			 * Destructor
+			 */
+			~Span(void) {
+				if (active_) 
+					record(Event{std::string(name_), std::string(category_), std::string(detail_), 
+						start_, now() - start_, thread()});
+			}
+		};
+
+		/**
+		 * The tracing which lasts until the end of the scope. The
+		 * recorded spans are dropped at the end on every path, so
+		 * a failed build doesn't leave its spans to the next one.
+		 */
+		class Recording {
+		protected:
+			bool active_{false};		// Set if the tracing was enabled by the object
+
+		public:
+			/**
+			 * Constructor
+			 * @param active true to enable the tracing
+			 */
+			explicit Recording(bool active) : active_{active} {
+				if (active_) enable();
+			}
+
+			/**
+			 * The tracing can't be copied, it would be disabled twice
+			 */
+			Recording(const Recording& other) = delete;
+			Recording& operator=(const Recording& other) = delete;
+
+			/**
+			 * Destructor
+			 */
+			~Recording(void) {
+				if (active_) disable();
+			}
+		};
+	} // namespace trace
+} // namespace mmix
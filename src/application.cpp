@@ -32,85 +32,162 @@ Application::Application(std::vector<std::string> input_files, std::string outpu
 	output_file_{output_file} {}
 
 void Application::start(void) {
-	mmix::Parser parser(read());
-	mmix::Macroprocessor macroprocessor(parser.get());
-	mmix::Preprocessor preprocessor(macroprocessor.get());
+	// Unchanged files are loaded from the cache if it's enabled
+	auto cache = cache_.empty() ? nullptr : std::make_shared<mmix::Cache>(resolve(cache_));
+
+	// Record the spans of the stages (until the build ends or fails)
+	mmix::trace::Recording recording(not trace_.empty());
+
+	auto raw = stage("read", [&]() { 
+		return read(); 
+	});
+
+	// The program is built in the memory
+	mmix::assembler::Options options;
+	options.jobs 		= jobs_;
+	options.cache 		= cache;
+	options.pipeline 	= pipeline_;
+	options.compile 	= mode_ != PREPROCESSING;
+	options.stage 		= [this](const std::string& name, const std::function<void()>& function) { 
+		stage(name, function); 
+	};
+	mmix::Assembler assembler(raw, options);
+	compiler_ = assembler.compiler();
 
 	// Process the program according to the mode
 	switch (mode_) {
 		// Write the result of preprocessing
 		case PREPROCESSING:
-			write(preprocessor.get());
+			stage("write", [&]() { write(assembler.preprocessed()); });
 			break;
 
 		// Compile the program and write it to the file
 		case FULL:
 		case COMPILATION:
-			compiler_ = std::make_shared<mmix::Compiler>(preprocessor.get());
-			write(compiler_->get());
+			stage("write", [&]() {
+				if (format_ == OutputFormat::MMO) write_object(compiler_->get(), compiler_->entry());
+				else write(compiler_->get());
+			});
 			break;
 	}
+
+	if (not trace_.empty()) {
+		std::ofstream trace_stream(resolve(trace_));
+		if (!trace_stream.is_open())
+			throw std::invalid_argument("The trace file is not correct!");
+
+		mmix::trace::write(trace_stream);
+	}
+
+	if (not stats_) return;
+
+	// The sizes of the program
+	uint64_t lines = 0;
+	for (const auto& [name, file] : *raw) lines += file->size();
+
+	stats_->count("files", raw->size());
+	stats_->count("lines", lines);
+	stats_->count("labels", assembler.labels());
+	stats_->count("instructions", assembler.preprocessed()->size());
+	if (compiler_) stats_->count("bytes", compiler_->get()->size());
+	stats_->count("arena_bytes", assembler.arena()->size());
+
+	stats_->report(*report_, stats_format_ == StatsFormat::JSON);
 }
 
 std::shared_ptr<RawProgram> Application::read(void) {
-	std::string line;
-	std::ifstream input_stream;
 	auto program = std::make_shared<RawProgram>();
 
-	for (auto file : input_files_) {
-		input_stream.open(file);
-		auto source = std::make_shared<RawFile>();
+	// The files which are already read go first, they can be included by the others
+	if (sources_) program->insert(sources_->begin(), sources_->end());
 
-		// Check if the file was opened
-		if (!input_stream.is_open())
-			throw std::ifstream::failure("File was not opened!");
+	// Map every other file, the program keeps the mappings alive
+	for (auto file : input_files_) 
+		if (not program->count(file)) 
+			program->insert(std::make_pair(file, std::make_shared<RawFile>(resolve(file))));
 
-		// Store every line of the program
-		while (!input_stream.eof()) {
-			std::getline(input_stream, line);
-			if (not line.empty()) source->push_back(line);
-		}
+	return program;
+}
 
-		// Close the stream
-		input_stream.close();
+void Application::write(std::shared_ptr<CompiledProgram> program) {
+	std::ofstream output_stream(resolve(output_file_), std::ios::binary);
 
-		// Push the file to the map
-		program->insert(std::make_pair(file, source));
-	}
+	// Check if the file was opened
+    if (!output_stream.is_open())
+        throw std::invalid_argument("The output file is not correct!");
 
-	return program;
+	// Store every octabyte of the memory into the file, the lines are encoded in batches
+	mmix::compiler::Chunk 	batch;
+	std::string 			buffer;
+	batch.reserve(batch_size);
+	auto flush = [&]() {
+		write_lines(output_stream, batch, buffer);
+		batch.clear();
+	};
+
+	mmix::compiler::for_each_octa(*program, [&](uint64_t code) {
+		batch.push_back(code);
+		if (batch.size() == batch_size) flush();
+	});
+	flush();
+
+	// Close the stream
+    output_stream.close();
 }
 
-void Application::write(std::shared_ptr<CompiledProgram> program) {
-	std::ofstream output_stream(output_file_);
-	std::stringstream hex_stream;
+void Application::write_lines(std::ostream& output_stream, const mmix::compiler::Chunk& codes, std::string& buffer) {
+	buffer.resize(codes.size() * mmix::hex::line_size);
+	mmix::hex::encode(codes.data(), codes.size(), buffer.data());
+	output_stream.write(buffer.data(), buffer.size());
+}
+
+void Application::write_object(std::shared_ptr<CompiledProgram> program, uint64_t entry) {
+	std::ofstream output_stream(resolve(output_file_), std::ios::binary);
 
 	// Check if the file was opened
     if (!output_stream.is_open())
         throw std::invalid_argument("The output file is not correct!");
 
-	// Store every value into the file
-	for (auto code : *program) {
-		std::stringstream hex_stream;
-		hex_stream << std::setfill('0') << std::setw(16) << std::left << std::hex << code; 
-		output_stream << hex_stream.str() << std::endl;
-	}
+	// Write the whole object at once
+	auto object = mmix::ObjectWriter(program, entry).get();
+	output_stream.write(object->data(), object->size());
 
 	// Close the stream
     output_stream.close();
 }
 
 void Application::write(std::shared_ptr<mmix::preprocessor::PreprocessedProgram> program) {
-	std::ofstream output_stream(output_file_);
+	std::ofstream output_stream(resolve(output_file_));
 
 	// Check if the file was opened
     if (!output_stream.is_open())
         throw std::invalid_argument("The output file is not correct!");
 
 	// Store every value into the file
-	for (auto instruction : *program) { 
-		instruction->write(output_stream);
-		output_stream << std::endl;
+	uint64_t address = mmix::constants::text_segment;
+	for (const auto& [origin, extent] : *program) {
+		// Keep the relocation if the extent doesn't follow the previous one
+		if (origin != address) {
+			std::stringstream hex_stream;
+			hex_stream << "#" << std::hex << std::uppercase << origin;
+
+			auto 			address_string = hex_stream.str();
+			mmix::Operand 	parameter;
+			parameter.text 	= address_string;
+
+			mmix::Directive relocation;
+			relocation.directive 	= "LOC";
+			relocation.parameters 	= mmix::Instruction::Parameters(&parameter, 1);
+			relocation.write(output_stream);
+			output_stream << std::endl;
+		}
+
+		for (auto instruction : extent) { 
+			instruction->write(output_stream);
+			output_stream << std::endl;
+		}
+
+		address = origin + extent.size();
 	}
 
 	// Close the stream
@@ -119,4 +196,51 @@ void Application::write(std::shared_ptr<mmix::preprocessor::PreprocessedProgram>
 
 void Application::set_mode(const Application::CompilationMode& value) {
 	mode_ = value;
-}
\ No newline at end of file
+}
+
+void Application::set_format(const Application::OutputFormat& value) {
+	format_ = value;
+}
+
+void Application::set_jobs(size_t value) {
+	jobs_ = value;
+}
+
+void Application::set_cache(const std::string& value) {
+	cache_ = value;
+}
+
+void Application::set_pipeline(bool value) {
+	pipeline_ = value;
+}
+
+void Application::set_stats(const StatsFormat& value) {
+	stats_format_ 	= value;
+	stats_ 			= value == StatsFormat::NONE ? nullptr : std::make_shared<mmix::Statistics>();
+}
+
+void Application::set_trace(const std::string& value) {
+	trace_ = value;
+}
+
+void Application::set_directory(const std::string& value) {
+	directory_ = value;
+}
+
+std::string Application::resolve(const std::string& path) const {
+	// An absolute path stays as it is
+	return directory_.empty() ? path : (directory_ / path).string();
+}
+
+void Application::add_source(const std::string& name, std::string content) {
+	add_source(name, RawFile::from_content(std::move(content)));
+}
+
+void Application::add_source(const std::string& name, std::shared_ptr<RawFile> file) {
+	if (not sources_) sources_ = std::make_shared<RawProgram>();
+	(*sources_)[name] = file;
+}
+
+void Application::set_report(std::ostream& value) {
+	report_ = &value;
+}
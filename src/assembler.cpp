@@ -0,0 +1,149 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "assembler.h"
+
+// Include C++ STL headers
+#include <future>
+
+// Include project headers
+#include "hex.h"
+
+namespace mmix {
+	Assembler::Assembler(const std::vector<assembler::Source>& sources, const assembler::Options& options) :
+		arena_{std::make_shared<Arena>()},
+		symbols_{std::make_shared<SymbolTable>()},
+		raw_{std::make_shared<parser::RawProgram>()} {
+		for (const auto& source : sources) 
+			raw_->insert(std::make_pair(std::string(source.name), parser::RawFile::from_view(source.content)));
+
+		assemble(options);
+	}
+
+	Assembler::Assembler(std::shared_ptr<parser::RawProgram> program, const assembler::Options& options) :
+		arena_{std::make_shared<Arena>()},
+		symbols_{std::make_shared<SymbolTable>()},
+		raw_{program} {
+		assemble(options);
+	}
+
+	void Assembler::assemble(const assembler::Options& options) {
+		auto stage = [&options](const std::string& name, const std::function<void()>& function) {
+			if (options.stage) options.stage(name, function);
+			else function();
+		};
+
+		std::shared_ptr<Parser> parser;
+		std::shared_ptr<Macroprocessor> macroprocessor;
+		std::shared_ptr<Preprocessor> preprocessor;
+		stage("parse", [&]() { 
+			parser = std::make_shared<Parser>(raw_, arena_, symbols_, options.jobs, options.cache); 
+		});
+		stage("macroprocess", [&]() { 
+			macroprocessor = std::make_shared<Macroprocessor>(parser->get(), arena_, symbols_); 
+		});
+		bool pipelined = options.pipeline and options.compile;
+		stage("preprocess", [&]() { 
+			preprocessor = std::make_shared<Preprocessor>(macroprocessor->get(), arena_, symbols_, pipelined); 
+		});
+		preprocessed_ 	= preprocessor->get();
+		labels_ 		= preprocessor->labels();
+
+		if (not options.compile) return;
+		if (not pipelined) {
+			stage("compile", [&]() { 
+				compiler_ = std::make_shared<Compiler>(preprocessed_, arena_, symbols_); 
+			});
+			return;
+		}
+
+		// The preprocessor places the instructions on another thread and streams them to the compiler
+		stage("place+compile", [&]() {
+			auto stream 	= std::make_shared<preprocessor::Stream>(preprocessor::stream_capacity);
+			auto placement 	= std::async(std::launch::async, [preprocessor, stream]() { 
+				preprocessor->stream(*stream); 
+			});
+
+			try {
+				compiler_ = std::make_shared<Compiler>(stream, preprocessed_, arena_, symbols_);
+			}
+			catch (...) {
+				// Stop the preprocessor, its error comes first (the compiler could see a part of the program)
+				stream->close();
+				placement.get();
+				throw;
+			}
+			placement.get();
+		});
+	}
+
+	std::vector<assembler::Segment> Assembler::segments(void) const {
+		std::vector<assembler::Segment> result;
+		if (not compiler_) return result;
+
+		for (const auto& [origin, extent] : *compiler_->get()) 
+			result.push_back(assembler::Segment{origin, Span<const uint8_t>(extent.data(), extent.size())});
+		return result;
+	}
+
+	std::shared_ptr<compiler::CompiledProgram> Assembler::image(void) const {
+		return compiler_ ? compiler_->get() : nullptr;
+	}
+
+	std::string Assembler::hex(void) const {
+		if (not compiler_) return std::string();
+
+		// Encode every line at once
+		compiler::Chunk codes;
+		compiler::for_each_octa(*compiler_->get(), [&codes](uint64_t code) { codes.push_back(code); });
+
+		std::string result(codes.size() * hex::line_size, '\0');
+		hex::encode(codes.data(), codes.size(), result.data());
+		return result;
+	}
+
+	std::shared_ptr<mmo::Buffer> Assembler::object(void) const {
+		if (not compiler_) return std::make_shared<mmo::Buffer>();
+		return ObjectWriter(compiler_->get(), compiler_->entry()).get();
+	}
+
+	std::shared_ptr<preprocessor::PreprocessedProgram> Assembler::preprocessed(void) const {
+		return preprocessed_;
+	}
+
+	size_t Assembler::labels(void) const {
+		return labels_;
+	}
+
+	std::shared_ptr<parser::RawProgram> Assembler::sources(void) const {
+		return raw_;
+	}
+
+	std::shared_ptr<Arena> Assembler::arena(void) const {
+		return arena_;
+	}
+
+	std::shared_ptr<SymbolTable> Assembler::symbols(void) const {
+		return symbols_;
+	}
+
+	std::shared_ptr<Compiler> Assembler::compiler(void) const {
+		return compiler_;
+	}
+} // namespace mmix
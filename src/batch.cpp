@@ -0,0 +1,161 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "batch.h"
+
+// Include C++ STL headers
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <iterator>
+
+// Include project headers
+#include "exceptions.h"
+
+using mmix::exceptions::application::WrongManifestException;
+
+namespace mmix {
+	Batch::Batch(const std::string& manifest, const batch::Configure& configure, size_t threads) {
+		auto start = std::chrono::steady_clock::now();
+		read_manifest(manifest);
+
+		// The results are collected in the order of the jobs
+		std::vector<std::future<batch::Result>> futures;
+		{
+			ThreadPool pool(threads);
+			futures.reserve(jobs_.size());
+			for (const auto& job : jobs_) 
+				futures.push_back(pool.submit([this, &job, &configure]() { return run(job, configure); }));
+		}
+
+		results_.reserve(futures.size());
+		for (auto& future : futures) results_.push_back(future.get());
+
+		seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void Batch::read_manifest(const std::string& manifest) {
+		std::ifstream input_stream(manifest);
+
+		// Check if the file was opened
+		if (!input_stream.is_open())
+			throw std::ifstream::failure("File was not opened!");
+
+		std::string line;
+		for (size_t number = 1; std::getline(input_stream, line); ++number) {
+			// Skip the comments and the empty lines
+			std::stringstream words(line.substr(0, line.find('#')));
+			std::vector<std::string> tokens{std::istream_iterator<std::string>(words), std::istream_iterator<std::string>()};
+			if (tokens.empty()) continue;
+
+			// The inputs, the arrow and a single output
+			auto arrow = std::find(tokens.begin(), tokens.end(), "->");
+			if (arrow == tokens.begin() or arrow == tokens.end() or std::next(arrow, 2) != tokens.end()) 
+				throw WrongManifestException(manifest + ":" + std::to_string(number) + " " + line);
+
+			jobs_.push_back(batch::Job{std::vector<std::string>(tokens.begin(), arrow), tokens.back(), number});
+		}
+	}
+
+	std::shared_ptr<parser::RawFile> Batch::file(const std::string& name) {
+		std::promise<std::shared_ptr<parser::RawFile>> promise;
+		std::shared_future<std::shared_ptr<parser::RawFile>> result;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			// Another job has read the file or is reading it
+			auto iterator = files_.find(name);
+			if (iterator != files_.end()) result = iterator->second;
+			else files_.emplace(name, promise.get_future().share());
+		}
+		if (result.valid()) return result.get();
+
+		// The error of the file fails every job which uses it
+		try {
+			auto file = std::make_shared<parser::RawFile>(name);
+			promise.set_value(file);
+			return file;
+		}
+		catch (...) {
+			promise.set_exception(std::current_exception());
+			throw;
+		}
+	}
+
+	batch::Result Batch::run(const batch::Job& job, const batch::Configure& configure) {
+		batch::Result result;
+		std::stringstream output;
+		auto start = std::chrono::steady_clock::now();
+
+		try {
+			auto application = configure(job);
+			for (const auto& input : job.inputs) application->add_source(input, file(input));
+
+			application->set_report(output);
+			application->start();
+		}
+		catch (const std::exception& exception) {
+			result.error = exception.what();
+		}
+
+		result.output 	= output.str();
+		result.seconds 	= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	const std::vector<batch::Job>& Batch::jobs(void) const {
+		return jobs_;
+	}
+
+	const std::vector<batch::Result>& Batch::results(void) const {
+		return results_;
+	}
+
+	size_t Batch::failed(void) const {
+		return std::count_if(results_.begin(), results_.end(), [](const auto& result) { 
+			return not result.error.empty(); 
+		});
+	}
+
+	void Batch::report(std::ostream& stream) const {
+		// The reports of the builds
+		for (size_t index = 0; index < jobs_.size(); ++index) 
+			if (not results_[index].output.empty()) 
+				stream << jobs_[index].output << " :" << std::endl << results_[index].output;
+
+		// The errors are listed with the lines of the manifest
+		for (size_t index = 0; index < jobs_.size(); ++index) 
+			if (not results_[index].error.empty()) 
+				stream << "failed " << jobs_[index].output << " (line " << jobs_[index].line << ") : " 
+					<< results_[index].error << std::endl;
+
+		// The slowest job is the lower bound of the batch time
+		double slowest = 0;
+		for (const auto& result : results_) slowest = std::max(slowest, result.seconds);
+
+		stream << std::fixed << std::setprecision(3)
+			<< "jobs " << jobs_.size() 
+			<< ", succeeded " << jobs_.size() - failed() 
+			<< ", failed " << failed() 
+			<< ", wall ms " << seconds_ * 1000 
+			<< ", slowest job ms " << slowest * 1000 << std::endl;
+	}
+} // namespace mmix
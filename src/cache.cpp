@@ -0,0 +1,396 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "cache.h"
+
+// Include C++ STL headers
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <thread>
+#include <cstring>
+
+// Include system headers
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <process.h>
+#endif // _WIN32
+
+namespace {
+	const char magic[] = "MMIXASMC";		// The first bytes of an entry
+
+	/**
+	 * Flags of an operand record (the low bits are the type)
+	 */
+	enum Flags : uint8_t {
+		TYPE 		= 0x07,
+		RESOLVED 	= 0x08,
+		SYMBOL 		= 0x10
+	};
+
+	/**
+	 * Get the FNV-1a hash of the names of the keywords, the
+	 * opcodes are indexes of the table so it must not change
+	 * @return the hash
+	 */
+	constexpr uint64_t fingerprint(void) {
+		uint64_t result = 0xcbf29ce484222325ULL;
+
+		for (const auto& keyword : mmix::keywords::table) {
+			for (auto character : keyword.name) {
+				result ^= static_cast<uint8_t>(character);
+				result *= 0x100000001b3ULL;
+			}
+			result ^= keyword.type;
+			result *= 0x100000001b3ULL;
+		}
+
+		return result;
+	}
+
+	/**
+	 * Append an integer to the buffer
+	 * @param buffer the buffer to append to
+	 * @param value the integer
+	 */
+	template <typename T>
+	void put(std::string& buffer, T value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	/**
+	 * Append an integer as LEB128 (7 bits per byte), so small
+	 * numbers and lengths take a single byte
+	 * @param buffer the buffer to append to
+	 * @param value the integer
+	 */
+	void put_varint(std::string& buffer, uint64_t value) {
+		for (; value >= 0x80; value >>= 7) buffer.push_back(static_cast<char>(value | 0x80));
+		buffer.push_back(static_cast<char>(value));
+	}
+
+	/**
+	 * Take an integer from the data
+	 * @param data the data (moved past the integer)
+	 * @param value the integer
+	 * @return false if the data is too short
+	 */
+	template <typename T>
+	bool get(std::string_view& data, T& value) {
+		if (data.size() < sizeof(T)) return false;
+
+		std::memcpy(&value, data.data(), sizeof(T));
+		data.remove_prefix(sizeof(T));
+		return true;
+	}
+
+	/**
+	 * Take a LEB128 integer from the data
+	 * @param data the data (moved past the integer)
+	 * @param value the integer
+	 * @return false if the data is too short or the integer is too long
+	 */
+	bool get_varint(std::string_view& data, uint64_t& value) {
+		value = 0;
+
+		for (unsigned shift = 0; shift < 64 and not data.empty(); shift += 7) {
+			auto byte = static_cast<uint8_t>(data.front());
+			data.remove_prefix(1);
+
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (not (byte & 0x80)) return true;
+		}
+
+		return false;
+	}
+} // namespace
+
+namespace mmix {
+	Cache::Cache(const std::string& directory) : directory_{directory} {
+		std::error_code error;
+		std::filesystem::create_directories(directory_, error);
+	}
+
+	uint64_t Cache::hash(std::string_view content) {
+		uint64_t result = 0xcbf29ce484222325ULL;
+
+		for (auto character : content) {
+			result ^= static_cast<uint8_t>(character);
+			result *= 0x100000001b3ULL;
+		}
+
+		return result;
+	}
+
+	std::string Cache::path(uint64_t hash) const {
+		std::stringstream stream;
+		stream << std::hex << std::setfill('0') << std::setw(16) << hash << ".mmc";
+		return (std::filesystem::path(directory_) / stream.str()).string();
+	}
+
+	void Cache::write(const Instruction* instruction, Encoder& encoder) {
+		std::string_view 	opcode;
+		const Instruction* 	expression = nullptr;
+
+		switch (instruction->kind) {
+			case Instruction::Kind::MNEMONIC: 	
+				opcode = static_cast<const Mnemonic*>(instruction)->mnemonic; 
+				break;
+			case Instruction::Kind::MACRO: 		
+				opcode 		= static_cast<const Macro*>(instruction)->type;
+				expression 	= static_cast<const Macro*>(instruction)->expression;
+				break;
+			case Instruction::Kind::ALLOCATOR: 	
+				opcode = static_cast<const Allocator*>(instruction)->size; 
+				break;
+			case Instruction::Kind::DIRECTIVE: 	
+				opcode = static_cast<const Directive*>(instruction)->directive; 
+				break;
+		}
+
+		// A symbol is stored as its index in the entry plus one (0 is no symbol)
+		auto put_symbol = [&encoder](symbols::Id id) {
+			if (id == symbols::none) {
+				put_varint(encoder.records, 0);
+				return;
+			}
+
+			auto index = encoder.symbols.emplace(id, static_cast<uint32_t>(encoder.symbols.size())).first->second;
+			put_varint(encoder.records, index + 1);
+		};
+
+		put_varint(encoder.records, keywords::find(opcode) - keywords::table.data());
+
+		// The fields go in the order the parser interns the symbols: operands, label, expression
+		put_varint(encoder.records, instruction->parameters.size());
+		for (const auto& parameter : instruction->parameters) {
+			uint8_t flags = parameter.type;
+			if (parameter.resolved) 					flags |= Flags::RESOLVED;
+			if (parameter.symbol != symbols::none) 	flags |= Flags::SYMBOL;
+
+			put<uint8_t>(encoder.records, flags);
+			put_varint(encoder.records, parameter.text.size());
+			encoder.strings.append(parameter.text);
+			if (flags & Flags::SYMBOL) 		put_symbol(parameter.symbol);
+			if (flags & Flags::RESOLVED) 	put_varint(encoder.records, parameter.value);
+		}
+
+		put_varint(encoder.records, instruction->label.size());
+		encoder.strings.append(instruction->label);
+		put_symbol(instruction->symbol);
+
+		if (instruction->kind == Instruction::Kind::MACRO) {
+			put<uint8_t>(encoder.records, expression != nullptr);
+			if (expression) write(expression, encoder);
+		}
+	}
+
+	Instruction* Cache::read(Decoder& decoder) {
+		InstructionFactory 	factory(decoder.arena);
+		auto& 				data = decoder.records;
+
+		// Take a string from the strings of the entry
+		auto get_string = [&decoder](std::string_view& value) {
+			uint64_t size;
+			if (not get_varint(decoder.records, size) or size > decoder.strings.size()) return false;
+
+			value = decoder.strings.substr(0, size);
+			decoder.strings.remove_prefix(size);
+			return true;
+		};
+
+		// A new symbol is interned when it's met the first time, as the parser does it
+		auto get_symbol = [&decoder](symbols::Id& id, std::string_view name) {
+			uint64_t index;
+			if (not get_varint(decoder.records, index) or index > decoder.symbols.size() + 1) return false;
+
+			if (index == 0) id = symbols::none;
+			else if (index <= decoder.symbols.size()) id = decoder.symbols[index - 1];
+			else {
+				id = decoder.table.intern(name);
+				decoder.symbols.push_back(id);
+			}
+			return true;
+		};
+
+		// Opcodes are taken from the keyword table, so they don't need a copy
+		uint64_t index;
+		if (not get_varint(data, index) or index >= keywords::table.size()) return nullptr;
+		const auto& keyword = keywords::table[index];
+
+		Instruction* instruction = nullptr;
+		switch (keyword.type) {
+			case keywords::Type::MNEMONIC: {
+				auto concrete_instruction 		= factory.create_mnemonic();
+				concrete_instruction->mnemonic 	= keyword.name;
+				instruction 					= concrete_instruction;
+				break;
+			}
+			case keywords::Type::MACRO: {
+				auto concrete_instruction 	= factory.create_macro();
+				concrete_instruction->type 	= keyword.name;
+				instruction 				= concrete_instruction;
+				break;
+			}
+			case keywords::Type::SIZE: {
+				auto concrete_instruction 	= factory.create_allocator();
+				concrete_instruction->size 	= keyword.name;
+				instruction 				= concrete_instruction;
+				break;
+			}
+			case keywords::Type::DIRECTIVE: {
+				auto concrete_instruction 		= factory.create_directive();
+				concrete_instruction->directive = keyword.name;
+				instruction 					= concrete_instruction;
+				break;
+			}
+		}
+
+		// The operands are decoded right into the arena
+		uint64_t size;
+		if (not get_varint(data, size) or size > data.size()) return nullptr;
+		instruction->parameters = decoder.arena.array<Operand>(size);
+		for (auto& parameter : instruction->parameters) {
+			uint8_t flags;
+			if (not get(data, flags) or (flags & Flags::TYPE) > Operand::Type::EXPRESSION) return nullptr;
+			if (not get_string(parameter.text)) return nullptr;
+
+			parameter.type 		= static_cast<Operand::Type>(flags & Flags::TYPE);
+			parameter.resolved 	= flags & Flags::RESOLVED;
+			if ((flags & Flags::SYMBOL) and not get_symbol(parameter.symbol, parameter.text)) return nullptr;
+			if (parameter.resolved and not get_varint(data, parameter.value)) return nullptr;
+		}
+
+		if (not get_string(instruction->label) or not get_symbol(instruction->symbol, instruction->label)) 
+			return nullptr;
+
+		// Read the expression of a macro
+		if (instruction->kind == Instruction::Kind::MACRO) {
+			uint8_t has_expression;
+			if (not get(data, has_expression)) return nullptr;
+			if (has_expression) {
+				auto expression = read(decoder);
+				if (not expression) return nullptr;
+				static_cast<Macro*>(instruction)->expression = expression;
+			}
+		}
+
+		return instruction;
+	}
+
+	bool Cache::load(std::string_view content, 
+		Instructions& instructions, 
+		bool& is_main, 
+		Arena& arena, 
+		SymbolTable& symbols) const {
+		auto key = hash(content);
+
+		// Read the whole entry at once
+		std::ifstream stream(path(key), std::ios::binary | std::ios::ate);
+		if (not stream.is_open()) return false;
+		std::string buffer(static_cast<size_t>(stream.tellg()), '\0');
+		stream.seekg(0);
+		if (not stream.read(buffer.data(), buffer.size())) return false;
+		std::string_view data(buffer);
+
+		// Check the header
+		uint32_t entry_version;
+		uint64_t entry_size, entry_hash, entry_keywords, count, symbols_count, strings_size;
+		uint8_t  entry_main;
+		if (data.substr(0, sizeof(magic) - 1) != std::string_view(magic, sizeof(magic) - 1)) return false;
+		data.remove_prefix(sizeof(magic) - 1);
+		if (not get(data, entry_version) or entry_version != version) return false;
+		if (not get(data, entry_size) or entry_size != content.size()) return false;
+		if (not get(data, entry_hash) or entry_hash != key) return false;
+		if (not get(data, entry_keywords) or entry_keywords != fingerprint()) return false;
+		if (not get(data, entry_main) or not get(data, count)) return false;
+		if (not get(data, symbols_count) or not get(data, strings_size)) return false;
+
+		// The hash only picks the entry, the content must be the same
+		if (data.substr(0, content.size()) != content) return false;
+		data.remove_prefix(content.size());
+		if (strings_size > data.size()) return false;
+
+		// The strings are copied into the arena with a single allocation
+		Decoder decoder{data.substr(strings_size), arena.copy(data.substr(0, strings_size)), {}, arena, symbols};
+		decoder.symbols.reserve(symbols_count);
+
+		// Read the instructions, a broken entry is a miss
+		auto first = instructions.size();
+		instructions.reserve(first + count);
+		for (uint64_t index = 0; index < count; ++index) {
+			auto instruction = read(decoder);
+			if (not instruction) {
+				instructions.resize(first);
+				return false;
+			}
+			instructions.push_back(instruction);
+		}
+		if (not decoder.records.empty() or not decoder.strings.empty()) {
+			instructions.resize(first);
+			return false;
+		}
+
+		is_main = entry_main;
+		return true;
+	}
+
+	void Cache::store(std::string_view content, const Instructions& instructions, bool is_main) const {
+		auto key = hash(content);
+
+		Encoder encoder;
+		for (auto instruction : instructions) write(instruction, encoder);
+
+		std::string buffer(magic, sizeof(magic) - 1);
+		put<uint32_t>(buffer, version);
+		put<uint64_t>(buffer, content.size());
+		put<uint64_t>(buffer, key);
+		put<uint64_t>(buffer, fingerprint());
+		put<uint8_t>(buffer, is_main);
+		put<uint64_t>(buffer, instructions.size());
+		put<uint64_t>(buffer, encoder.symbols.size());
+		put<uint64_t>(buffer, encoder.strings.size());
+		buffer.append(content);
+		buffer.append(encoder.strings);
+		buffer.append(encoder.records);
+
+		// Write a temporary file and rename it, so a reader never sees a partial entry
+		// (the name is unique for every process and thread sharing the directory)
+		std::stringstream suffix;
+#ifndef _WIN32
+		suffix << ".tmp" << getpid() << "-" << std::this_thread::get_id();
+#else
+		suffix << ".tmp" << _getpid() << "-" << std::this_thread::get_id();
+#endif // _WIN32
+		auto target 	= path(key);
+		auto temporary 	= target + suffix.str();
+		{
+			std::ofstream stream(temporary, std::ios::binary);
+			if (not stream.is_open()) return;
+			stream.write(buffer.data(), buffer.size());
+			if (not stream) return;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporary, target, error);
+		if (error) std::filesystem::remove(temporary, error);
+	}
+} // namespace mmix
@@ -19,107 +19,270 @@
 
 #include "compiler.h"
 
-using mmix::compiler::sizes;
-using mmix::compiler::mnemonics;
+using mmix::exceptions::compiler::WrongOperandException;
+using mmix::exceptions::compiler::NoEntryPointException;
 
 namespace mmix {
-	Compiler::Compiler(std::shared_ptr<preprocessor::PreprocessedProgram> program) :
+	Compiler::Compiler(std::shared_ptr<preprocessor::PreprocessedProgram> program, 
+	std::shared_ptr<Arena> arena, 
+	std::shared_ptr<SymbolTable> symbols) :
 	program_{std::make_shared<preprocessor::PreprocessedProgram>(*program)},
 	compiled_{std::make_shared<compiler::CompiledProgram>()},
-	data_table_{std::make_shared<DataTable>()} {
+	data_table_{std::make_shared<DataTable>(symbols->size())},
+	arena_{arena},
+	symbols_{symbols} {
 		// Compile the program
-		fill_table();
 		compile();
+		finish();
 	}
 
-	void Compiler::convert(std::shared_ptr<Mnemonic>& instruction) {
-		uint64_t code = 0;
+	Compiler::Compiler(std::shared_ptr<preprocessor::Stream> stream, 
+	std::shared_ptr<preprocessor::PreprocessedProgram> program, 
+	std::shared_ptr<Arena> arena, 
+	std::shared_ptr<SymbolTable> symbols) :
+	compiled_{std::make_shared<compiler::CompiledProgram>()},
+	data_table_{std::make_shared<DataTable>(symbols->size())},
+	arena_{arena},
+	symbols_{symbols} {
+		// Compile the chunks while the rest of the program is being placed
+		compile(*stream);
+
+		// The image is needed only to compile it again
+		if (not sequential_) program_ = std::make_shared<preprocessor::PreprocessedProgram>(*program);
+		finish();
+	}
+
+	void Compiler::finish(void) {
+		resolve();
+
+		// An overlapping extent could overwrite a byte before its fixup, compile 
+		// the program again with every label known (nothing is deferred then)
+		if (not sequential_) {
+			compiled_ = std::make_shared<compiler::CompiledProgram>();
+			fill_table();
+			compile();
+			resolve();
+		}
+	}
 
-		// Convert parameters into digital representation
-		for (auto parameter : instruction->parameters) {
-			if (parameter.front() == '$') code |= stoi(parameter.substr(1));
-			else code |= stoi(parameter);
+	uint8_t Compiler::size_of(std::string_view size) {
+		// The codes of the sizes are 1 for "BYTE" up to 4 for "OCTA"
+		return 1 << (keywords::find(size)->code - 1);
+	}
+
+	void Compiler::convert(Mnemonic* instruction) {
+		// Instructions are aligned tetrabytes
+		pad(compiler::tetra_size);
 
-			// Shift the code to store the next parameter
-			code <<= 8;
-		} 
+		// The fields of the parameters from the right : "X, Y, Z", "X, YZ" or "XYZ"
+		auto& parameters = instruction->parameters;
+		if (parameters.size() > 3) throw WrongOperandException(std::string(instruction->mnemonic));
 
-		// Add the code of the mnemonic into the code
-		code |= static_cast<uint64_t>(mnemonics.find(instruction->mnemonic)->second) << (7 * 8);
+		uint64_t code 	= static_cast<uint64_t>(keywords::find(instruction->mnemonic)->code) << 24;
+		uint8_t shift 	= 24;
+		for (size_t index = 0; index < parameters.size(); ++index) {
+			uint8_t width = index + 1 == parameters.size() ? shift : 8;
+			shift -= width;
+
+			// The field of a label defined later is filled by a fixup
+			if (is_forward(parameters[index])) defer(parameters[index], compiler::tetra_size, shift, width);
+			else code |= (value(parameters[index]) & ((1ULL << width) - 1)) << shift;
+		}
 
-		// Push a new value into the vector
-		compiled_->push_back(code);
+		emit(code, compiler::tetra_size);
 	}
 
-	void Compiler::allocate(std::string size, std::string value) {
+	void Compiler::allocate(std::string_view size, std::string_view value) {
 		// Store each symbol of the string separately
-		for (auto character : value) {
-			if (character != '\"');
-				compiled_->push_back(static_cast<uint8_t>(character));
+		for (auto character : value) allocate(size, static_cast<uint8_t>(character));
+	}
+
+	void Compiler::allocate(std::string_view size, uint64_t value) {
+		auto bytes = size_of(size);
+		pad(bytes);
+		emit(value, bytes);
+	}
+
+	void Compiler::allocate(std::string_view size, const Operand& operand) {
+		// The whole value is filled by a fixup
+		auto bytes = size_of(size);
+		pad(bytes);
+		defer(operand, bytes, 0, bytes * 8);
+		emit(0, bytes);
+	}
+
+	void Compiler::emit(uint64_t value, uint8_t size) {
+		for (int8_t iteration = size - 1; iteration >= 0; --iteration) {
+			uint8_t byte = (value >> (iteration * 8)) & 0xFF;
+			compiled_->push_back(byte);
+		}
+	}
+
+	void Compiler::pad(uint64_t alignment) {
+		auto address = compiled_->address();
+		emit(0, align(address, alignment) - address);
+	}
+
+	void Compiler::defer(const Operand& operand, uint8_t size, uint8_t shift, uint8_t width) {
+		fixups_.push_back(Fixup{compiled_->address(), &operand, size, shift, width});
+	}
+
+	void Compiler::resolve(void) {
+		trace::Span span("compiler", "resolve");
+
+		for (const auto& fixup : fixups_) {
+			// A label which is never defined fails the same way as any other bad operand
+			auto address = (*data_table_)[fixup.operand->symbol];
+			uint64_t label = address ? *address : value(*fixup.operand);
+			uint64_t mask = fixup.width < 64 ? (1ULL << fixup.width) - 1 : ~0ULL;
+
+			// The address in data has to fit the whole value
+			if (fixup.width == fixup.size * 8 and not fits(label, fixup.size)) 
+				throw WrongOperandException(std::string(fixup.operand->text));
+
+			// Read the big-endian value, fill the field and write it back
+			uint64_t code = 0;
+			for (uint8_t byte = 0; byte < fixup.size; ++byte) code = (code << 8) | compiled_->at(fixup.address + byte);
+			code |= (label & mask) << fixup.shift;
+			for (uint8_t byte = 0; byte < fixup.size; ++byte) 
+				compiled_->at(fixup.address + byte) = (code >> ((fixup.size - byte - 1) * 8)) & 0xFF;
 		}
+
+		fixups_.clear();
 	}
 
-	void Compiler::allocate(std::string size, uint32_t value) {
-		// Store each 8 bits of the value separately
-		for (int8_t iteration = sizes.find(size)->second - 1; iteration >= 0; --iteration)
-			compiled_->push_back((value >> (iteration * 8)) & 0xFF);
+	bool Compiler::is_forward(const Operand& operand) {
+		return operand.type == Operand::Type::SYMBOL and not operand.resolved;
+	}
+
+	uint64_t Compiler::entry(void) const {
+		auto symbol = symbols_->find("Main");
+		if (symbol == symbols::none or symbol >= data_table_->size() or not (*data_table_)[symbol]) 
+			throw NoEntryPointException();
+
+		return *(*data_table_)[symbol];
+	}
+
+	uint64_t Compiler::value(const Operand& operand) {
+		if (operand.resolved) return operand.value;
+
+		// The numbers are decoded by the parser, only expressions (e.g. "-1") are left
+		uint64_t result;
+		if (not Lexer::decode(operand.text, result)) throw WrongOperandException(std::string(operand.text));
+		return result;
 	}
 
 	std::shared_ptr<compiler::CompiledProgram> Compiler::get(void) {
 		return compiled_;
 	}
 
+	void Compiler::define(const Instruction* instruction, uint64_t address) {
+		if (instruction->symbol != symbols::none and not (*data_table_)[instruction->symbol]) 
+			(*data_table_)[instruction->symbol] = address;
+	}
+
 	void Compiler::fill_table(void) {
-		uint32_t offset = 0;
+		trace::Span span("compiler", "fill table");
 
-		// Iterate over addresses
-		for (uint64_t address = 0; address != program_->size(); ++address) {
-			auto instruction	= std::dynamic_pointer_cast<Allocator>(program_->at(address));
-			if (not instruction) continue;
+		for (const auto& [origin, extent] : *program_) {
+			uint64_t address = origin;
 
-			// If there is a label on the data, push it to the table
-			if (not instruction->label.empty()) data_table_->insert(AllocatedData(instruction->label, address + offset));
+			// Lay out the instructions the same way as they are compiled
+			for (auto instruction : extent) {
+				if (instruction->kind == Instruction::Kind::MNEMONIC) {
+					address = align(address, compiler::tetra_size);
+					define(instruction, address);
+					address += compiler::tetra_size;
+				}
+				else if (instruction->kind == Instruction::Kind::ALLOCATOR) {
+					auto bytes 				= size_of(static_cast<Allocator*>(instruction)->size);
+					const auto& parameter 	= instruction->parameters.at(0);
 
-			// FIXME : use lexer to determine the type of the data
-			// Calculate an offset to an actual address after allocation
-			offset += sizes.find(instruction->size)->second;
+					// A string allocates every character
+					address = align(address, bytes);
+					define(instruction, address);
+					address += parameter.type == Operand::Type::STRING ? bytes * (parameter.text.size() - 2) : bytes;
+				}
+			}
 		}
 	}
 
 	void Compiler::replace_labels(Instruction::Parameters& parameters) {
 		// Iterate over parameters
 		for (auto& parameter : parameters) {
-			auto iterator = data_table_->find(parameter);
+			if (parameter.type != Operand::Type::SYMBOL) continue;
 
 			// If there is a label, change it to the address associated with it
-			if (iterator != data_table_->end())
-				parameter = std::to_string(iterator->second);
+			if (auto address = (*data_table_)[parameter.symbol])
+				parameter = Operand::constant(*address);
 		}
 	}
 
-	void Compiler::compile(void) {
-		for (auto& base_instruction : *program_) {
-			auto& parameters = base_instruction->parameters;
-		
-			// Replace labels with the address associated with it
-			replace_labels(parameters);
+	void Compiler::compile(Instruction* base_instruction) {
+		auto& parameters = base_instruction->parameters;
 
+		switch (base_instruction->kind) {
 			// If the instruction contains mnemonics, compile it
-			if (auto instruction = std::dynamic_pointer_cast<Mnemonic>(base_instruction)) {
-				convert(instruction);
-			}
+			case Instruction::Kind::MNEMONIC: 
+				define(base_instruction, align(compiled_->address(), compiler::tetra_size));
+				replace_labels(parameters);
+				convert(static_cast<Mnemonic*>(base_instruction));
+				break;
+
 			// If the instruction means to allocate memory, allocate it and save the label of the data
-			else if (auto instruction = std::dynamic_pointer_cast<Allocator>(base_instruction)){
-				auto parameter 	= parameters.at(0);
-				auto size		= instruction->size;
-
-				if (parameter.front() == '$') 
-					allocate(size, std::stoi(parameter.substr(1)));
-				else if (parameter.front() == '\"' and parameter.back() == '\"')
-					allocate(size, parameter.substr(1, parameter.size() - 2));
-				else
-					allocate(size, std::stoi(parameter));
+			case Instruction::Kind::ALLOCATOR: {
+				auto instruction 		= static_cast<Allocator*>(base_instruction);
+				auto size				= instruction->size;
+				define(instruction, align(compiled_->address(), size_of(size)));
+				replace_labels(parameters);
+
+				const auto& parameter 	= parameters.at(0);
+				if (parameter.type == Operand::Type::STRING)
+					allocate(size, parameter.text.substr(1, parameter.text.size() - 2));
+				else if (is_forward(parameter))
+					allocate(size, parameter);
+				else {
+					// The value which doesn't fit the size isn't truncated silently
+					auto data = value(parameter);
+					if (not fits(data, size_of(size))) 
+						throw WrongOperandException(parameter.text.empty() ? 
+							std::to_string(data) : std::string(parameter.text));
+					allocate(size, data);
+				}
+				break;
 			}
+
+			default:
+				break;
+		}
+	}
+
+	void Compiler::compile(void) {
+		trace::Span span("compiler", "compile");
+
+		for (const auto& [origin, extent] : *program_) {
+			// The fixups can be applied as long as the extents don't overlap
+			if (origin < compiled_->address()) sequential_ = false;
+
+			// Continue compilation from the origin of the extent
+			compiled_->locate(origin);
+
+			for (auto instruction : extent) compile(instruction);
+		}
+	}
+
+	void Compiler::compile(preprocessor::Stream& stream) {
+		trace::Span span("compiler", "compile stream");
+
+		preprocessor::Chunk chunk;
+		while (stream.pop(chunk)) {
+			// A new extent is compiled from its origin, as the extents of the image are
+			if (chunk.extent) {
+				if (chunk.origin < compiled_->address()) sequential_ = false;
+				compiled_->locate(chunk.origin);
+			}
+
+			for (auto instruction : chunk.instructions) compile(instruction);
 		}
 	}
-}
\ No newline at end of file
+}
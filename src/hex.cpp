@@ -0,0 +1,192 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "hex.h"
+
+// Include C++ STL headers
+#include <array>
+#include <cstring>
+
+// Include the intrinsics of the target
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace mmix {
+	namespace hex {
+		namespace {
+			/**
+			 * The digits of every byte
+			 */
+			constexpr std::array<char, 512> make_pairs(void) {
+				constexpr char symbols[] = "0123456789abcdef";
+				std::array<char, 512> result{};
+				for (size_t byte = 0; byte < 256; ++byte) {
+					result[byte * 2] 		= symbols[byte >> 4];
+					result[byte * 2 + 1] 	= symbols[byte & 0x0F];
+				}
+				return result;
+			}
+
+			constexpr auto pairs = make_pairs();
+
+			/**
+			 * Write an octabyte two digits at a time
+			 * @param value the octabyte to encode
+			 * @param output the buffer for the digits
+			 */
+			inline void encode_scalar(uint64_t value, char* output) {
+				for (int byte = 7; byte >= 0; --byte, value >>= 8) 
+					std::memcpy(output + byte * 2, &pairs[(value & 0xFF) * 2], 2);
+			}
+
+			/**
+			 * Reverse the bytes, so the most significant one is stored first
+			 * @param value the value to reverse
+			 * @return the reversed value
+			 */
+			inline uint64_t big_endian(uint64_t value) {
+#if defined(__GNUC__)
+				return __builtin_bswap64(value);
+#else
+				uint64_t result = 0;
+				for (int byte = 0; byte < 8; ++byte, value >>= 8) result = (result << 8) | (value & 0xFF);
+				return result;
+#endif
+			}
+
+#if defined(__SSE2__)
+			/**
+			 * Convert nibbles (one per byte) into lowercase hex digits
+			 * @param nibbles the values from 0 to 15
+			 * @return the digits
+			 */
+			inline __m128i digits_sse2(__m128i nibbles) {
+				// The letters are 39 characters after "9" + 1
+				auto letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+				return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+			}
+
+			/**
+			 * Write an octabyte as 16 digits with SSE2
+			 * @param value the octabyte to encode
+			 * @param output the buffer for the digits
+			 */
+			inline void encode_sse2(uint64_t value, char* output) {
+				auto reversed 	= big_endian(value);
+				auto bytes 		= _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&reversed));
+				auto mask 		= _mm_set1_epi8(0x0F);
+
+				// Interleave the high and the low nibbles of every byte
+				auto high 		= _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+				auto low 		= _mm_and_si128(bytes, mask);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output), digits_sse2(_mm_unpacklo_epi8(high, low)));
+			}
+#endif
+
+#if defined(__AVX2__)
+			/**
+			 * Write two octabytes as two lines with AVX2
+			 * @param values the octabytes to encode
+			 * @param output the buffer for the lines
+			 */
+			inline void encode_avx2(const uint64_t* values, char* output) {
+				auto bytes = _mm_set_epi64x(static_cast<long long>(big_endian(values[1])), 
+					static_cast<long long>(big_endian(values[0])));
+
+				// Every byte becomes a pair of nibbles : the high one first
+				auto words 		= _mm256_cvtepu8_epi16(bytes);
+				auto mask 		= _mm256_set1_epi16(0x0F);
+				auto nibbles 	= _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(words, 4), mask), 
+					_mm256_slli_epi16(_mm256_and_si256(words, mask), 8));
+
+				auto letters 	= _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), 
+					_mm256_set1_epi8('a' - '0' - 10));
+				auto result 	= _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm256_castsi256_si128(result));
+				output[digits] = '\n';
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + line_size), _mm256_extracti128_si256(result, 1));
+				output[line_size + digits] = '\n';
+			}
+#endif
+
+			/**
+			 * Write octabytes as lines, one octabyte at a time
+			 * @param values the octabytes to encode
+			 * @param count the number of octabytes
+			 * @param output the buffer for the lines
+			 */
+			template <void (*Encode)(uint64_t, char*)>
+			void encode_lines(const uint64_t* values, size_t count, char* output) {
+				for (size_t index = 0; index < count; ++index, output += line_size) {
+					Encode(values[index], output);
+					output[digits] = '\n';
+				}
+			}
+
+#if defined(__AVX2__)
+			/**
+			 * Write octabytes as lines, two octabytes at a time
+			 * @param values the octabytes to encode
+			 * @param count the number of octabytes
+			 * @param output the buffer for the lines
+			 */
+			void encode_lines_avx2(const uint64_t* values, size_t count, char* output) {
+				size_t index = 0;
+				for (; index + 2 <= count; index += 2, output += 2 * line_size) 
+					encode_avx2(values + index, output);
+
+				// The last odd line
+				encode_lines<encode_sse2>(values + index, count - index, output);
+			}
+#endif
+		} // namespace
+
+		void encode(uint64_t value, char* output) {
+#if defined(__SSE2__)
+			encode_sse2(value, output);
+#else
+			encode_scalar(value, output);
+#endif
+		}
+
+		void encode(const uint64_t* values, size_t count, char* output) {
+#if defined(__AVX2__)
+			encode_lines_avx2(values, count, output);
+#elif defined(__SSE2__)
+			encode_lines<encode_sse2>(values, count, output);
+#else
+			encode_lines<encode_scalar>(values, count, output);
+#endif
+		}
+
+		std::vector<Path> paths(void) {
+			return {
+				Path{"scalar", encode_lines<encode_scalar>}, 
+#if defined(__SSE2__)
+				Path{"sse2", encode_lines<encode_sse2>}, 
+#endif
+#if defined(__AVX2__)
+				Path{"avx2", encode_lines_avx2}, 
+#endif
+			};
+		}
+	} // namespace hex
+} // namespace mmix
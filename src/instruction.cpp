@@ -20,43 +20,69 @@
 #include "instruction.h"
 
 namespace mmix {
-	std::shared_ptr<Macro> InstructionFactory::create_macro() {
-		return std::make_shared<Macro>();
+	Macro* InstructionFactory::create_macro() {
+		return arena_.create<Macro>();
 	}
 
-	std::shared_ptr<Mnemonic> InstructionFactory::create_mnemonic() {
-		return std::make_shared<Mnemonic>();
+	Mnemonic* InstructionFactory::create_mnemonic() {
+		return arena_.create<Mnemonic>();
 	}
 
-	std::shared_ptr<Allocator> InstructionFactory::create_allocator() {
-		return std::make_shared<Allocator>();
+	Allocator* InstructionFactory::create_allocator() {
+		return arena_.create<Allocator>();
 	}
 
-	std::shared_ptr<Directive> InstructionFactory::create_directive() {
-		return std::make_shared<Directive>();
+	Directive* InstructionFactory::create_directive() {
+		return arena_.create<Directive>();
+	}
+
+	void Instruction::write(std::ostream& stream) const noexcept {
+		switch (kind) {
+			case Kind::MNEMONIC: 	static_cast<const Mnemonic*>(this)->write(stream); break;
+			case Kind::MACRO: 		static_cast<const Macro*>(this)->write(stream); break;
+			case Kind::ALLOCATOR: 	static_cast<const Allocator*>(this)->write(stream); break;
+			case Kind::DIRECTIVE: 	static_cast<const Directive*>(this)->write(stream); break;
+		}
+	}
+
+	Instruction* Instruction::clone(Arena& arena) const {
+		switch (kind) {
+			case Kind::MNEMONIC: 	return static_cast<const Mnemonic*>(this)->clone(arena);
+			case Kind::MACRO: 		return static_cast<const Macro*>(this)->clone(arena);
+			case Kind::ALLOCATOR: 	return static_cast<const Allocator*>(this)->clone(arena);
+			case Kind::DIRECTIVE: 	return static_cast<const Directive*>(this)->clone(arena);
+		}
+
+		return nullptr;
+	}
+
+	Mnemonic* Mnemonic::clone(Arena& arena) const {
+		return arena.create<Mnemonic>(*this);
 	}
 
 	void Mnemonic::write(std::ostream& stream) const noexcept {
-		stream << (label.empty() ? "" : (label + " "));
+		if (not label.empty()) stream << label << " ";
 		stream << mnemonic << " ";
 
 		// Pass every parameter to the stream
-		for (auto it = parameters.begin(); it != (parameters.end() - 1); ++it)
-			stream << *it << ",";
-		stream << parameters.back();
+		for (auto it = parameters.begin(); it != parameters.end(); ++it)
+			stream << (it == parameters.begin() ? "" : ",") << *it;
 
 		// Get to the next line
 		stream << std::endl;
 	}
 
+	Macro* Macro::clone(Arena& arena) const {
+		return arena.create<Macro>(*this);
+	}
+
 	void Macro::write(std::ostream& stream) const noexcept {
-		stream << (label.empty() ? "" : (label + " "));
+		if (not label.empty()) stream << label << " ";
 		stream << '\b' << " ";
 
 		// Pass every parameter to the stream
-		for (auto it = parameters.begin(); it != (parameters.end() - 1); ++it)
-			stream << *it << ",";
-		stream << parameters.back();
+		for (auto it = parameters.begin(); it != parameters.end(); ++it)
+			stream << (it == parameters.begin() ? "" : ",") << *it;
 
 		// If there is an instruction print it
 		if (expression) expression->write(stream);
@@ -65,27 +91,33 @@ namespace mmix {
 		stream << std::endl;
 	}
 
+	Allocator* Allocator::clone(Arena& arena) const {
+		return arena.create<Allocator>(*this);
+	}
+
 	void Allocator::write(std::ostream& stream) const noexcept {
-		stream << (label.empty() ? "" : (label + " "));
+		if (not label.empty()) stream << label << " ";
 		stream << size << " ";
 
 		// Pass every parameter to the stream
-		for (auto it = parameters.begin(); it != (parameters.end() - 1); ++it)
-			stream << *it << ",";
-		stream << parameters.back();
+		for (auto it = parameters.begin(); it != parameters.end(); ++it)
+			stream << (it == parameters.begin() ? "" : ",") << *it;
 
 		// Get to the next line
 		stream << std::endl;
 	}
 
+	Directive* Directive::clone(Arena& arena) const {
+		return arena.create<Directive>(*this);
+	}
+
 	void Directive::write(std::ostream& stream) const noexcept {
-		stream << (label.empty() ? "" : (label + " "));
+		if (not label.empty()) stream << label << " ";
 		stream << directive << " ";
 
 		// Pass every parameter to the stream
-		for (auto it = parameters.begin(); it != (parameters.end() - 1); ++it)
-			stream << *it << ",";
-		stream << parameters.back();
+		for (auto it = parameters.begin(); it != parameters.end(); ++it)
+			stream << (it == parameters.begin() ? "" : ",") << *it;
 
 		// Get to the next line
 		stream << std::endl;
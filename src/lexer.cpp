@@ -0,0 +1,192 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "lexer.h"
+
+// Include C++ STL headers
+#include <cctype>
+#include <charconv>
+
+using mmix::lexer::Token;
+using mmix::lexer::Tokens;
+using mmix::lexer::TokenType;
+
+namespace {
+	/**
+	 * Check if the character ends a field
+	 * @param character the character to check
+	 * @return true if it's a space
+	 */
+	inline bool is_space(char character) {
+		return character == ' ' or character == '\t' or character == '\r';
+	}
+
+	/**
+	 * Check if the character can be a part of a symbol
+	 * @param character the character to check
+	 * @return true if it's a letter, a digit or a special symbol character
+	 */
+	inline bool is_symbol(char character) {
+		return std::isalnum(static_cast<unsigned char>(character)) or 
+			character == '_' or character == ':' or character == '@';
+	}
+} // namespace
+
+namespace mmix {
+	size_t Lexer::skip_spaces(std::string_view line, size_t position) {
+		while (position < line.size() and is_space(line[position])) ++position;
+		return position;
+	}
+
+	size_t Lexer::scan_word(std::string_view line, size_t position) {
+		while (position < line.size() and not is_space(line[position])) ++position;
+		return position;
+	}
+
+	size_t Lexer::scan_operands(std::string_view line, size_t position, Tokens& tokens) {
+		while (position < line.size() and not is_space(line[position])) {
+			const char 	character 	= line[position];
+			size_t 		start 		= position++;
+			TokenType 	type;
+
+			// String and character literals (with the quotes)
+			if (character == '\"' or character == '\'') {
+				while (position < line.size() and line[position] != character) ++position;
+				if (position < line.size()) ++position;
+				type = TokenType::STRING;
+			}
+			// Registers
+			else if (character == '$') {
+				while (position < line.size() and is_symbol(line[position])) ++position;
+				type = TokenType::REGISTER;
+			}
+			// Decimal and hexadecimal constants
+			else if (std::isdigit(static_cast<unsigned char>(character)) or character == '#') {
+				while (position < line.size() and is_symbol(line[position])) ++position;
+				type = TokenType::IMMEDIATE;
+			}
+			// Symbols and macro parameters
+			else if (is_symbol(character) or 
+				(character == '&' and position < line.size() and is_symbol(line[position]))) {
+				while (position < line.size() and is_symbol(line[position])) ++position;
+				type = TokenType::IDENTIFIER;
+			}
+			else if (character == ',') 
+				type = TokenType::SEPARATOR;
+			// Operators (the two-character ones are "==", "!=", "<=", ">=", "<<" and ">>")
+			else {
+				if (position < line.size() and 
+					((line[position] == '=' and std::string_view("=!<>").find(character) != std::string_view::npos) or
+					 ((character == '<' or character == '>') and line[position] == character)))
+					++position;
+				type = TokenType::OPERATOR;
+			}
+
+			tokens.push_back(Token{type, line.substr(start, position - start)});
+		}
+
+		return position;
+	}
+
+	bool Lexer::is_opcode(std::string_view word) {
+		return keywords::find(word) != nullptr;
+	}
+
+	TokenType Lexer::classify(std::string_view operand) {
+		thread_local Tokens tokens;
+
+		tokenize_operands(operand, tokens);
+		return tokens.empty() ? TokenType::IDENTIFIER : tokens.front().type;
+	}
+
+	bool Lexer::decode(std::string_view operand, uint64_t& value) {
+		if (operand.empty()) return false;
+
+		const char* first 	= operand.data();
+		const char* last 	= operand.data() + operand.size();
+		int 		base 	= 10;
+		bool 		negative = false;
+
+		switch (*first) {
+			// Registers are numbered from 0 to 255
+			case '$': {
+				auto [end, error] = std::from_chars(first + 1, last, value);
+				return first + 1 != last and error == std::errc() and end == last and value <= 0xFF;
+			}
+
+			case '#':
+				++first;
+				base = 16;
+				break;
+
+			case '-':
+				++first;
+				negative = true;
+				break;
+
+			default:
+				break;
+		}
+
+		// A sign or a prefix without digits isn't a number (from_chars doesn't take them)
+		if (first == last or not std::isxdigit(static_cast<unsigned char>(*first))) return false;
+
+		auto [end, error] = std::from_chars(first, last, value, base);
+		if (error != std::errc() or end != last) return false;
+
+		if (negative) value = ~value + 1;
+		return true;
+	}
+
+	void Lexer::tokenize(std::string_view line, Tokens& tokens) {
+		tokens.clear();
+
+		// Skip the indentation and empty lines
+		size_t position = skip_spaces(line, 0);
+		if (position == line.size()) return;
+
+		// A line which starts with something else than a symbol is a comment
+		if (not is_symbol(line[position])) return;
+
+		// The first word is a label if it's not an opcode
+		size_t end = scan_word(line, position);
+		auto word = line.substr(position, end - position);
+		if (not is_opcode(word)) {
+			tokens.push_back(Token{TokenType::LABEL, word});
+
+			position = skip_spaces(line, end);
+			end = scan_word(line, position);
+			word = line.substr(position, end - position);
+		}
+		tokens.push_back(Token{TokenType::OPCODE, word});
+
+		// Scan the operands
+		position = scan_operands(line, skip_spaces(line, end), tokens);
+
+		// The rest of the line is an expression of a macro or a comment
+		position = skip_spaces(line, position);
+		if (position != line.size() and word == "MACRO") 
+			tokens.push_back(Token{TokenType::EXPRESSION, line.substr(position)});
+	}
+
+	void Lexer::tokenize_operands(std::string_view operands, Tokens& tokens) {
+		tokens.clear();
+		scan_operands(operands, 0, tokens);
+	}
+} // namespace mmix
@@ -27,82 +27,117 @@ using mmix::exceptions::macroprocessor::UnknownMacroException;
 using mmix::exceptions::macroprocessor::NoMainFileException;
 using mmix::exceptions::macroprocessor::MacroNotFoundException;
 using mmix::exceptions::macroprocessor::FileNotFoundException;
+using mmix::exceptions::macroprocessor::IncludeCycleException;
+using mmix::exceptions::macroprocessor::WrongConditionException;
+using mmix::exceptions::macroprocessor::UnmatchedBranchingException;
 
 namespace mmix {
-	Macroprocessor::Macroprocessor(std::shared_ptr<ParsedProgram> sources) :
-		sources_{std::make_shared<ParsedProgram>(*sources)},
+	Macroprocessor::Macroprocessor(std::shared_ptr<ParsedProgram> sources, 
+		std::shared_ptr<Arena> arena, 
+		std::shared_ptr<SymbolTable> symbols) :
 		program_{std::make_shared<MacroprocessedProgram>()},
-		macro_table_{std::make_shared<MacroTable>()} {
-		// Find the main file
-		auto iterator = std::find_if(sources_->begin(), sources_->end(), 
-			[](const auto& pair) { return pair.first.second; });
-		if (iterator == sources_->end()) throw NoMainFileException();
+		macro_table_{std::make_shared<MacroTable>()},
+		arena_{arena},
+		symbols_{symbols} {
+		// Number the files, the main one is remembered
+		std::optional<FileId> main;
+		for (const auto& [file, content] : *sources) {
+			auto id = static_cast<FileId>(macro_table_->size());
+			if (file.second and not main) main = id;
+
+			macro_table_->push_back(File{file.first, content, MacroEntries(), MacroLabels(), 
+				std::vector<FileId>(), Inclusion::UNVISITED});
+			file_ids_.emplace(file.first, id);
+		}
+		if (not main) throw NoMainFileException();
 
 		// Process the program
 		fill_tables();
 		process_branching();
 		replace_macros();
-		include_files(iterator->first.first);
-
-		// Return only the main file
-		program_ = iterator->second;
+		include_files(*main);
 	}
 
 	void Macroprocessor::fill_tables(void) {
-		for (auto [file, content] : *sources_) {
-			const auto 		filename = file.first;
-
-			// Push the file's tables into the global tables
-			macro_table_->insert(std::make_pair(filename, MacroEntries()));
-
-			// Iterate over addresses
-			auto iterator = content->begin();
-			while (iterator != content->end()) {
-				auto instruction = std::dynamic_pointer_cast<Macro>(*iterator);
-
-				// Skip if instruction is macro
-				if (not instruction) {
-					++iterator;
+		trace::Span span("macroprocessor", "fill tables");
+
+		for (FileId id = 0; id < macro_table_->size(); ++id) {
+			auto& file 		= macro_table_->at(id);
+			auto& content 	= *file.content;
+
+			// The instructions are moved to the front in a single pass, the offsets
+			// of the macros are the positions in the compacted file
+			size_t offset = 0;
+			branches_.clear();
+			for (auto element : content) {
+				// Keep the instruction if it's not a macro
+				if (element->kind != Instruction::Kind::MACRO) {
+					content[offset++] = element;
 					continue;
 				}
+				auto instruction = static_cast<Macro*>(element);
 
-				// Insert a new macro
-				auto offset = std::distance(content->begin(), iterator);
-				auto macro = process_macro(instruction, offset, filename);
-				macro_table_->at(filename).push_back(macro);
+				// Insert a new macro (a label refers to its first definition)
+				auto macro = process_macro(instruction, offset, id);
+				file.entries.push_back(macro);
+				if (instruction->symbol != symbols::none and not macro->label.empty()) 
+					file.labels.emplace(instruction->symbol, macro);
 
-				// Remove known macros
-				content->erase(iterator);
+				// A macro use keeps its place for the expansion, other macros are removed
+				if (macro->kind == MacroEntry::Kind::USE) content[offset++] = element;
 			}
+			content.resize(offset);
+
+			// Every branching macro of the file must be closed
+			if (not branches_.empty()) throw UnmatchedBranchingException(std::string(branches_.back()->expression));
 		}
 	}
 
-	void Macroprocessor::include_files(const std::string& target_filename) {
-		const auto& target_file = std::find_if(sources_->begin(), sources_->end(), 
-			[=](const auto& pair) { return pair.first.first == target_filename; })->second;
-		const auto& target_table = macro_table_->at(target_filename);
+	void Macroprocessor::include_files(FileId main) {
+		trace::Span span("macroprocessor", "include files");
 
-		// Iterate over the include table for the given file
-		for (const auto& entry : target_table) {	
-			// Sanity check
-			auto macro = std::dynamic_pointer_cast<IncludeMacro>(entry);
-			if (not macro) continue;
+		// Resolve the includes of every file
+		for (auto& file : *macro_table_) {
+			for (const auto& entry : file.entries) {
+				if (entry->kind != MacroEntry::Kind::INCLUDE) continue;
+				auto macro = std::static_pointer_cast<IncludeMacro>(entry);
+				file.includes.push_back(find_file(macro->filename));
+			}
+		}
 
-			// Get include file content
-			const auto& source_iterator = std::find_if(sources_->begin(), sources_->end(), 
-				[=](const auto& pair) { return pair.first.first == macro->filename; });
-			if (source_iterator == sources_->end()) throw FileNotFoundException(macro->filename);
+		// The program holds every reachable file once
+		size_t size = 0;
+		for (const auto& file : *macro_table_) size += file.content->size();
+		program_->reserve(size);
 
-			// FIXME : don't include already included files
+		std::vector<FileId> chain;
+		include_file(main, chain);
+	}
 
-			// Recursion goes brrrrr...
-			include_files(macro->filename);
+	void Macroprocessor::include_file(FileId id, std::vector<FileId>& chain) {
+		auto& file = macro_table_->at(id);
 
-			// Merge files
-			target_file->insert(target_file->begin(), 
-				source_iterator->second->begin(), 
-				source_iterator->second->end());
+		// A file being included can't be reached again
+		if (file.state == Inclusion::VISITING) {
+			std::string cycle;
+			auto start = std::find(chain.begin(), chain.end(), id);
+			for (auto iterator = start; iterator != chain.end(); ++iterator) 
+				cycle += macro_table_->at(*iterator).name + " -> ";
+			throw IncludeCycleException(cycle + file.name);
 		}
+		if (file.state == Inclusion::INCLUDED) return;
+
+		trace::Span span("macroprocessor", "include file", file.name);
+
+		// The last include goes first, then the earlier ones and the file itself
+		file.state = Inclusion::VISITING;
+		chain.push_back(id);
+		for (auto iterator = file.includes.rbegin(); iterator != file.includes.rend(); ++iterator) 
+			include_file(*iterator, chain);
+		chain.pop_back();
+		file.state = Inclusion::INCLUDED;
+
+		program_->insert(program_->end(), file.content->begin(), file.content->end());
 	}
 
 	std::shared_ptr<MacroprocessedProgram> Macroprocessor::get() {
@@ -110,105 +145,123 @@ namespace mmix {
 	}
 
 	void Macroprocessor::replace_macros(void) {
-		for (auto& [filename, table] : *macro_table_) {
-			for (auto entry : table) {
-				auto macro = std::dynamic_pointer_cast<UseMacro>(entry);
-				if (not macro) continue;
-
-				// Expanding the macro 
-				auto instruction = expand_macro(macro, filename);
-
-				// Insert the new instruction
-				auto content = get_content(filename);
-				auto insert_iterator = content->begin() + macro->offset;
-				content->insert(insert_iterator, instruction);
+		for (FileId id = 0; id < macro_table_->size(); ++id) {
+			auto& file = macro_table_->at(id);
+
+			// The expansions of a file make a single batch
+			trace::Span span("macroprocessor", "expand macros", file.name);
+
+			for (auto entry : file.entries) {
+				if (entry->kind != MacroEntry::Kind::USE) continue;
+				auto macro = std::static_pointer_cast<UseMacro>(entry);
+
+				// A use in a branch which was cleared isn't expanded
+				auto& element = file.content->at(macro->offset);
+				if (not element) continue;
+
+				// Replace the use with the expanded macro
+				element = expand_macro(macro, id);
 			} 
 		}
 	}
 
 	void Macroprocessor::process_branching(void) {
-		for (auto& [filename, table] : *macro_table_) {
-			for (auto entry : table) {
-				auto base_macro = 
-					std::dynamic_pointer_cast<IBranchingMacro>(entry);
-				if (not base_macro) continue;
-
-				// If the macro depends on the definition, check if the macro was defined
-				if (auto macro = 
-					std::dynamic_pointer_cast<DefineBranchingMacro>(base_macro)) {
-					// Check the type of the macro and find the expression
-					if (not macro->type xor exists(filename, base_macro->expression)) {
-						// Erases unneeded instructions
-						clear(filename, macro->start_offset, macro->end_offset);
+		trace::Span span("macroprocessor", "process branching");
+
+		for (FileId id = 0; id < macro_table_->size(); ++id) {
+			for (auto entry : macro_table_->at(id).entries) {
+				switch (entry->kind) {
+					// If the macro depends on the definition, check if the macro was defined
+					case MacroEntry::Kind::DEFINE_BRANCHING: {
+						auto macro = std::static_pointer_cast<DefineBranchingMacro>(entry);
+
+						// Check the type of the macro and find the expression
+						if (not macro->type xor exists(id, macro->symbol)) {
+							// Erases unneeded instructions
+							clear(id, macro->start_offset, macro->end_offset);
+						}
+						break;
 					}
-				}
 
-				// If the macro depends on the macro content, check it
-				if (auto macro = 
-					std::dynamic_pointer_cast<ExprBranchingMacro>(base_macro)) {
-					if (check(filename, base_macro->expression)) {
-						if (macro->else_block.end != 0) 
-							clear(filename, macro->else_block.start, macro->else_block.end);	
-					}
-					else {
-						clear(filename, macro->if_block.start, macro->if_block.end);	
+					// If the macro depends on the macro content, check it
+					case MacroEntry::Kind::EXPRESSION_BRANCHING: {
+						auto macro = std::static_pointer_cast<ExprBranchingMacro>(entry);
+						if (check(id, macro->expression)) {
+							if (macro->else_block.end != 0) 
+								clear(id, macro->else_block.start, macro->else_block.end);	
+						}
+						else {
+							clear(id, macro->if_block.start, macro->if_block.end);	
+						}
+						break;
 					}
+
+					default:
+						break;
 				}
 			}
 		}
 	}
 
-	bool Macroprocessor::exists(const std::string& filename, 
-		const std::string& expr) {
-		// Find the expression
-		auto& table = macro_table_->at(filename);
-		auto expr_it = std::find_if(table.begin(), 
-			table.end(), [=](const auto& macro) { 
-				return macro->label == expr; 
-		});
-		return expr_it != table.end();
+	bool Macroprocessor::exists(FileId file, symbols::Id expr) {
+		const auto& labels = macro_table_->at(file).labels;
+		return labels.find(expr) != labels.end();
 	}
 
-	bool Macroprocessor::check(const std::string& filename, 
-		const std::string& expr) {
+	bool Macroprocessor::check(FileId file, std::string_view expr) {
+		lexer::Tokens tokens;
 
 		// FIXME : create functions to determine ">", "<" and so on
-		// FIXME : throw an exception
-		auto split = Parser::split_line(expr, "==");
-		auto& table = macro_table_->at(filename);
-		auto iterator = std::find_if(table.begin(), 
-			table.end(), [=](const auto& macro) { 
-				return macro->label == split[0]; 
+		Lexer::tokenize_operands(expr, tokens);
+		auto operation = std::find_if(tokens.begin(), tokens.end(), [](const auto& token) { 
+			return token.type == lexer::TokenType::OPERATOR and token.value == "=="; 
 		});
-		auto constant = std::dynamic_pointer_cast<ConstantMacro>(*iterator);
+		if (operation == tokens.end()) throw WrongConditionException(std::string(expr));
+
+		auto position 	= operation->value.data() - expr.data();
+		auto name 		= expr.substr(0, position);
+		auto value 		= expr.substr(position + operation->value.size());
+
+		Operand label;
+		label.text = name;
 
-		return constant->value == split[1];
+		auto entry = find_label(label, file);
+		if (entry->kind != MacroEntry::Kind::CONSTANT) throw UnknownMacroException(std::string(name));
+		auto constant = std::static_pointer_cast<ConstantMacro>(entry);
+
+		return constant->value == value;
 	}
 	
-	void Macroprocessor::clear(const std::string& filename, 
+	void Macroprocessor::clear(FileId file, 
 		size_t start, 
 		size_t end) {
-		auto content = get_content(filename);
+		auto content = get_content(file);
 
 		// Erase the instructions
 		for (auto it = content->begin() + start;
 			it != content->begin() + end; ++it)
-				it->reset();
+				*it = nullptr;
+	}
+
+	std::shared_ptr<mmix::parser::ParsedFile> Macroprocessor::get_content(FileId file) {
+		return macro_table_->at(file).content;
 	}
 
-	std::shared_ptr<mmix::parser::ParsedFile> 
-	Macroprocessor::get_content(const std::string& filename) {
-		// Get the content of the file
-		auto iterator = std::find_if(sources_->begin(), sources_->end(), 
-			[=](const auto& pair) { return pair.first.first == filename; });
-		if (iterator == sources_->end()) throw FileNotFoundException(filename);
+	Macroprocessor::FileId Macroprocessor::find_file(std::string_view filename) const {
+		auto iterator = file_ids_.find(std::string(filename));
+		if (iterator == file_ids_.end()) throw FileNotFoundException(std::string(filename));
 		return iterator->second;
 	}
 
+	symbols::Id Macroprocessor::identify(const Operand& operand) const {
+		if (operand.type == Operand::Type::SYMBOL) return operand.symbol;
+		return symbols_->find(operand.text);
+	}
+
 	std::shared_ptr<Macroprocessor::MacroEntry> 
-	Macroprocessor::process_macro(const std::shared_ptr<Macro>& value, 
+	Macroprocessor::process_macro(const Macro* value, 
 		size_t offset, 
-		const std::string& filename) {
+		FileId file) {
 		const auto type 		= value->type;
 		const auto label 		= value->label;
 		const auto parameters	= value->parameters;
@@ -219,71 +272,85 @@ namespace mmix {
 		}
 		else if (type == "INCLUDE") {
 			// FIXME : throw an exception when there are more parameters
-			return std::make_shared<IncludeMacro>(parameters.at(0));
+			return std::make_shared<IncludeMacro>(parameters.at(0).text);
 		}
 		else if (type == "USEMACRO") {
 			return std::make_shared<UseMacro>(parameters, offset);
 		}
 		else if (type == "DEFINE") {
 			// FIXME : throw an exception when there are more parameters
-			return std::make_shared<ConstantMacro>(label, parameters.at(0));
+			return std::make_shared<ConstantMacro>(label, parameters.at(0).text);
 		}
 		else if (type == "IFDEF" or type == "IFNDEF") {
 			// FIXME : throw an exception when there are more parameters
-			return std::make_shared<DefineBranchingMacro>(parameters.at(0), offset, type);
+			auto macro = std::make_shared<DefineBranchingMacro>(parameters.at(0).text, offset, type);
+			macro->symbol = identify(parameters.at(0));
+			branches_.push_back(macro);
+			return macro;
 		}
 		// FIXME : should also process "ELSE" and "ELSEIF"
 		else if (type == "IF") {
 			// FIXME : throw an exception when there are more parameters
-			return std::make_shared<ExprBranchingMacro>(parameters.at(0), offset);
+			auto macro = std::make_shared<ExprBranchingMacro>(parameters.at(0).text, offset);
+			branches_.push_back(macro);
+			return macro;
 		}
 		else if (type == "ENDIF") {
-			// Store the end address
-			auto& macro = (macro_table_->at(filename)).back();
-			auto br_makro = std::dynamic_pointer_cast<IBranchingMacro>(macro);
-			br_makro->end(offset);
+			// Store the end address of the innermost open macro
+			if (branches_.empty()) throw UnmatchedBranchingException(std::string(type));
+			branches_.back()->end(offset);
+			branches_.pop_back();
 		}
 		
 		return std::make_shared<MacroEntry>();
 	}
 
-	std::shared_ptr<Instruction> 
-	Macroprocessor::expand_macro(std::shared_ptr<UseMacro>& value, const std::string& filename) {
-		auto& 		parameters 	= value->parameters;
-		auto 		label 		= parameters.front();
+	Instruction* 
+	Macroprocessor::expand_macro(std::shared_ptr<UseMacro>& value, FileId file) {
+		auto& 	use_parameters 	= value->parameters;
+		auto& 	label 			= use_parameters.front();
 
 		// Remove the label from the parmaameters 
-		parameters.erase(parameters.begin());
+		auto parameters = Instruction::Parameters(use_parameters.begin() + 1, use_parameters.size() - 1);
 
 		// Get the corresponding macro table entry
-		auto macro = std::dynamic_pointer_cast<MacroExpression>(find_label(label, filename));
-		if (not macro) throw UnknownMacroException(label);
+		auto entry = find_label(label, file);
+		if (entry->kind != MacroEntry::Kind::EXPRESSION) throw UnknownMacroException(std::string(label.text));
+		auto macro = std::static_pointer_cast<MacroExpression>(entry);
 
-		// Get necessary data out of the entry
-		auto& expression 			= macro->expression;
-		auto& param_list 			= macro->parameters;
-		auto& expression_parameters	= expression->parameters;
+		// Every use of the macro gets its own copy of the expression
+		auto expression 				= macro->expression->clone(*arena_);
+		auto& param_list 				= macro->parameters;
+		std::vector<Operand> 			expression_parameters(expression->parameters.begin(), 
+			expression->parameters.end());
 
 		// Replace occurences in the instruction
-		for (auto& expression_param : expression_parameters)
+		for (auto& expression_param : expression_parameters) {
+			std::string text(expression_param.text);
 			for (uint64_t index = 0; index < parameters.size(); ++index) 
-				expression_param = Parser::replace_substr(expression_param, 
-					("&" + param_list.at(0)), 
-					parameters.at(index));
+				text = Parser::replace_substr(text, 
+					("&" + std::string(param_list.at(index).text)), 
+					std::string(parameters.at(index).text));
+
+			// The substituted text can be of another type
+			if (text != expression_param.text)
+				expression_param = Parser::create_operand(arena_->copy(text), *symbols_);
+		}
 
+		expression->parameters = arena_->copy<Operand>(expression_parameters.begin(), 
+			expression_parameters.end());
 		return expression;
 	}
 
 	std::shared_ptr<Macroprocessor::MacroEntry> 
-	Macroprocessor::find_label(const std::string& label, const std::string& filename) {
-		const auto& table = macro_table_->at(filename);
+	Macroprocessor::find_label(const Operand& label, FileId file) {
+		const auto& labels = macro_table_->at(file).labels;
 
 		// Look for the entry
-		for (auto entry : table) 
-			if (entry->label == label) 
-				return entry;
+		auto iterator = labels.find(identify(label));
+		if (iterator != labels.end()) return iterator->second;
 
 		// Throw an exception if the entry was not found
-		throw MacroNotFoundException(label);
+		throw MacroNotFoundException(std::string(label.text));
 	}
 } // namespace mmix
\ No newline at end of file
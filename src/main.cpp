@@ -25,46 +25,91 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <filesystem>
 
 // Include project headers
 #include "application.h"
+#include "options.h"
+#include "server.h"
+#include "batch.h"
 #include "exceptions.h"
 
-using CompilationMode = Application::CompilationMode;
+/**
+ * Send the build to the server and print the result
+ * @param path the path of the socket
+ * @param arguments the options of the build
+ * @return the exit status of the build
+ */
+int submit(const std::string& path, std::vector<std::string> arguments) {
+	mmix::server::Request request;
+	request.directory 	= std::filesystem::current_path().string();
+	request.arguments 	= std::move(arguments);
+
+	auto response = mmix::server::submit(path, request);
+	std::cout << response.output;
+	if (not response.error.empty()) std::cerr << response.error << std::endl;
+
+	return response.status;
+}
 
 int main(int argc, char** argv) {
+	// The client forwards the arguments to the server without parsing them
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+	for (size_t index = 0; index + 1 < arguments.size(); ++index) {
+		if (arguments[index] != "--connect") continue;
+
+		auto path = arguments[index + 1];
+		arguments.erase(arguments.begin() + index, arguments.begin() + index + 2);
+		return submit(path, arguments);
+	}
+
 	// Add options
-    boost::program_options::options_description desc("Allowed options");
-    desc.add_options()
-            ("help", "produce help message")
-            ("input,i", boost::program_options::value<std::vector<std::string>>()->multitoken(), "input "
-                "file")
-		    ("output,o", boost::program_options::value<std::string>(), "output "
-                "file")
-			("preprocessor,E", boost::program_options::bool_switch()->default_value(false), "Invoke preprocessor only");
+	auto desc = mmix::options::describe();
+	desc.add_options()
+			("serve", boost::program_options::value<std::string>(), "Serve the builds on the "
+				"Unix socket")
+			("connect", boost::program_options::value<std::string>(), "Send the build to the "
+				"server on the Unix socket (\"--connect <socket> --shutdown\" stops the server)")
+			("batch", boost::program_options::value<std::string>(), "Assemble the jobs of the "
+				"manifest (\"<inputs> -> <output>\" per line) on \"--jobs\" threads");
 
 	// Parse arguments
-    boost::program_options::variables_map vm;
-    boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
-            options(desc).run(), vm);
-    boost::program_options::notify(vm);
+	auto vm = mmix::options::parse(arguments, desc);
 
     if (vm.count("help")) {
         std::cout << "Usage: options_description [options]" << std::endl << desc;
         return 0;
     }
-	else if (!vm.count("input")) 
-		throw mmix::exceptions::application::MissingParameterException("input");
-	else if (!vm.count("output")) 
-		throw mmix::exceptions::application::MissingParameterException("output");
-
-    auto application = std::make_shared<Application>(vm["input"].as<std::vector<std::string>>(),
-		vm["output"].as<std::string>());
-	CompilationMode mode = vm["preprocessor"].as<bool>() ? 
-		CompilationMode::PREPROCESSING : 
-		CompilationMode::FULL;
-	application->set_mode(mode);
+
+	// Run the builds of the clients (the cache is used by the builds without their own)
+	if (vm.count("serve")) {
+		mmix::Server server(vm["serve"].as<std::string>(), 
+			vm.count("cache-dir") ? vm["cache-dir"].as<std::string>() : "");
+		server.run();
+		return 0;
+	}
+
+	// Every job is built on a single thread, the jobs run in parallel
+	if (vm.count("batch")) {
+		if (vm.count("trace")) 
+			throw mmix::exceptions::application::WrongParameterException("trace", vm["trace"].as<std::string>());
+
+		// The statistics are counted for the whole process, the parallel jobs would mix them
+		if (vm.count("stats") and vm["jobs"].as<size_t>() != 1) 
+			throw mmix::exceptions::application::WrongParameterException("stats", vm["stats"].as<std::string>());
+
+		mmix::Batch batch(vm["batch"].as<std::string>(), [&vm](const mmix::batch::Job& job) {
+			auto application = mmix::options::configure(vm, job.inputs, job.output);
+			application->set_jobs(1);
+			return application;
+		}, vm["jobs"].as<size_t>());
+
+		batch.report(std::cout);
+		return batch.failed() == 0 ? 0 : 1;
+	}
+
+    auto application = mmix::options::configure(vm);
     application->start();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,125 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "mmo.h"
+
+using mmix::compiler::CompiledProgram;
+
+namespace mmix {
+	ObjectWriter::ObjectWriter(std::shared_ptr<CompiledProgram> program, uint64_t entry) :
+		program_{program},
+		buffer_{std::make_shared<mmo::Buffer>()},
+		entry_{entry} {
+		// Every byte takes a quarter of a tetrabyte, extents take a few more for "lop_loc"
+		buffer_->reserve(program_->size() + 64 * sizeof(uint32_t));
+
+		write_preamble();
+		write_program();
+		write_postamble();
+	}
+
+	void ObjectWriter::tetra(uint32_t value) {
+		buffer_->push_back(static_cast<char>(value >> 24));
+		buffer_->push_back(static_cast<char>(value >> 16));
+		buffer_->push_back(static_cast<char>(value >> 8));
+		buffer_->push_back(static_cast<char>(value));
+	}
+
+	void ObjectWriter::lop(mmo::Lopcode lopcode, uint8_t y, uint8_t z) {
+		tetra((mmo::escape << 24) | (lopcode << 16) | (y << 8) | z);
+	}
+
+	void ObjectWriter::data(uint32_t value) {
+		// The loader would take the value for an instruction
+		if ((value >> 24) == mmo::escape) lop(mmo::Lopcode::QUOTE, 0, 1);
+		tetra(value);
+	}
+
+	void ObjectWriter::write_preamble(void) {
+		// The creation time is omitted to keep the object reproducible
+		lop(mmo::Lopcode::PRE, mmo::version, 0);
+	}
+
+	void ObjectWriter::write_program(void) {
+		for (const auto& [origin, extent] : *program_) {
+			// The object holds aligned tetrabytes, the bytes around the extent are zeros
+			uint64_t start 	= origin & ~uint64_t{3};
+			uint64_t end 	= (origin + extent.size() + 3) & ~uint64_t{3};
+
+			// Set the address of the extent
+			lop(mmo::Lopcode::LOC, 0, 2);
+			tetra(start >> 32);
+			tetra(start);
+
+			for (uint64_t address = start; address != end; address += sizeof(uint32_t)) {
+				uint32_t value = 0;
+				for (uint64_t byte = address; byte != address + sizeof(uint32_t); ++byte) 
+					value = (value << 8) | (byte >= origin and byte - origin < extent.size() ? extent[byte - origin] : 0);
+				data(value);
+			}
+		}
+	}
+
+	void ObjectWriter::write_postamble(void) {
+		// Set $255 to the entry point
+		lop(mmo::Lopcode::POST, 0, mmo::last_global);
+		tetra(entry_ >> 32);
+		tetra(entry_);
+
+		write_symbols();
+	}
+
+	void ObjectWriter::write_symbols(void) {
+		// The symbol table holds the only symbol ":Main" (a ternary trie)
+		mmo::Buffer symbols {
+			0x20, ':', 0x20, 'M', 0x20, 'a', 0x20, 'i',		// The prefix of the symbol
+		};
+
+		// The equivalent is stored in the fewest bytes, the addresses of the
+		// data segment are relative to it (the size gets 8 added then), as
+		// mmixal does it for the addresses below Data_Segment + 2^48 only.
+		// Other segments (e.g. Pool_Segment) keep the full value.
+		uint64_t equivalent = entry_;
+		uint8_t offset 		= 0;
+		if ((equivalent >> 48) == (constants::data_segment >> 48)) {
+			equivalent 	-= constants::data_segment;
+			offset 		= 8;
+		}
+
+		uint8_t bytes = 1;
+		while (bytes < 8 and (equivalent >> (bytes * 8)) != 0) ++bytes;
+
+		symbols.push_back(static_cast<char>(bytes + offset));
+		symbols.push_back('n');
+		for (int8_t byte = bytes - 1; byte >= 0; --byte) 
+			symbols.push_back(static_cast<char>(equivalent >> (byte * 8)));
+		symbols.push_back(static_cast<char>(0x81));		// The serial number
+
+		// The table takes whole tetrabytes
+		while (symbols.size() % sizeof(uint32_t) != 0) symbols.push_back(0);
+
+		lop(mmo::Lopcode::STAB, 0, 0);
+		buffer_->insert(buffer_->end(), symbols.begin(), symbols.end());
+		lop(mmo::Lopcode::END, 0, symbols.size() / sizeof(uint32_t));
+	}
+
+	std::shared_ptr<mmo::Buffer> ObjectWriter::get(void) {
+		return buffer_;
+	}
+} // namespace mmix
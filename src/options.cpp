@@ -0,0 +1,113 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "options.h"
+
+// Include project headers
+#include "exceptions.h"
+
+using CompilationMode = Application::CompilationMode;
+using OutputFormat = Application::OutputFormat;
+using StatsFormat = Application::StatsFormat;
+
+namespace mmix {
+	namespace options {
+		boost::program_options::options_description describe(void) {
+			boost::program_options::options_description desc("Allowed options");
+			desc.add_options()
+				("help", "produce help message")
+				("input,i", boost::program_options::value<std::vector<std::string>>()->multitoken(), "input "
+					"file")
+				("output,o", boost::program_options::value<std::string>(), "output "
+					"file")
+				("preprocessor,E", boost::program_options::bool_switch()->default_value(false), "Invoke preprocessor only")
+				("format", boost::program_options::value<std::string>()->default_value("hex"), "Format of the "
+					"compiled program (hex or mmo)")
+				("jobs,j", boost::program_options::value<size_t>()->default_value(1), "Number of threads "
+					"parsing the files (0 to use every core)")
+				("cache-dir", boost::program_options::value<std::string>(), "Directory of the cache of "
+					"parsed files")
+				("pipeline", boost::program_options::bool_switch()->default_value(false), "Compile the "
+					"instructions while the preprocessor places the rest of them")
+				("stats", boost::program_options::value<std::string>()->implicit_value("text"), "Print the "
+					"time and memory used by every stage (text or json)")
+				("trace", boost::program_options::value<std::string>(), "Write the spans of the "
+					"stages to the file as Chrome trace events");
+
+			return desc;
+		}
+
+		boost::program_options::variables_map parse(const std::vector<std::string>& arguments, 
+			const boost::program_options::options_description& description) {
+			boost::program_options::variables_map vm;
+			boost::program_options::store(boost::program_options::command_line_parser(arguments).
+				options(description).run(), vm);
+			boost::program_options::notify(vm);
+
+			return vm;
+		}
+
+		std::shared_ptr<Application> configure(const boost::program_options::variables_map& vm) {
+			if (!vm.count("input")) 
+				throw exceptions::application::MissingParameterException("input");
+			else if (!vm.count("output")) 
+				throw exceptions::application::MissingParameterException("output");
+
+			return configure(vm, vm["input"].as<std::vector<std::string>>(), vm["output"].as<std::string>());
+		}
+
+		std::shared_ptr<Application> configure(const boost::program_options::variables_map& vm, 
+			const std::vector<std::string>& inputs, 
+			const std::string& output) {
+			auto application = std::make_shared<Application>(inputs, output);
+			CompilationMode mode = vm["preprocessor"].as<bool>() ? 
+				CompilationMode::PREPROCESSING : 
+				CompilationMode::FULL;
+			application->set_mode(mode);
+
+			// Set the format of the output file
+			auto format = vm["format"].as<std::string>();
+			if (format == "mmo") application->set_format(OutputFormat::MMO);
+			else if (format == "hex") application->set_format(OutputFormat::HEX);
+			else throw exceptions::application::WrongParameterException("format", format);
+
+			// Set the number of threads
+			application->set_jobs(vm["jobs"].as<size_t>());
+
+			// Enable the cache of parsed files
+			if (vm.count("cache-dir")) application->set_cache(vm["cache-dir"].as<std::string>());
+
+			// Overlap the placement of the instructions with the compilation
+			application->set_pipeline(vm["pipeline"].as<bool>());
+
+			// Measure the stages
+			if (vm.count("stats")) {
+				auto stats = vm["stats"].as<std::string>();
+				if (stats == "text") application->set_stats(StatsFormat::TEXT);
+				else if (stats == "json") application->set_stats(StatsFormat::JSON);
+				else throw exceptions::application::WrongParameterException("stats", stats);
+			}
+
+			// Trace the stages
+			if (vm.count("trace")) application->set_trace(vm["trace"].as<std::string>());
+
+			return application;
+		}
+	} // namespace options
+} // namespace mmix
@@ -23,100 +23,175 @@ using mmix::parser::RawProgram;
 using mmix::parser::RawFile;
 using mmix::parser::ParsedFile;
 using mmix::parser::ParsedProgram;
-using mmix::preprocessor::directives;
-using mmix::compiler::mnemonics;
-using mmix::compiler::sizes;
-using mmix::macroprocessor::macros;
 using mmix::exceptions::parser::WrongLineException;
 using mmix::exceptions::parser::UnexpectedTokenException;
+using mmix::lexer::TokenType;
 
 namespace mmix {
-	Parser::Parser(std::shared_ptr<RawProgram> program) :
+	Parser::Parser(std::shared_ptr<RawProgram> program, 
+		std::shared_ptr<Arena> arena, 
+		std::shared_ptr<SymbolTable> symbols, 
+		size_t jobs, 
+		std::shared_ptr<Cache> cache) :
 		raw_{program},
-		parsed_{std::make_shared<parser::ParsedProgram>()} {
+		parsed_{std::make_shared<parser::ParsedProgram>()},
+		arena_{arena},
+		symbols_{symbols},
+		jobs_{jobs},
+		cache_{cache} {
 		parse();
 	}
 
-	Parser::SplittedLine Parser::split_line(std::string line, std::string delimiter, uint64_t count) {
-		std::vector<std::string>	result;
-		size_t 						pos = 0;
+	Instruction* Parser::parse_line(std::string_view line) {
+		std::string_view label;
+		std::string_view expression;
 
-		// Look up for the delimiter
-		while (((pos = line.find(delimiter)) != std::string::npos) and (count != 1)) {
-			// If the token is found, push it
-			if (pos != 0) {
-				result.push_back(line.substr(0, pos));
-				--count;
+		// Comment lines don't contain instructions
+		Lexer::tokenize(line, tokens_);
+		if (tokens_.empty()) return nullptr;
+		parameters_.clear();
+
+		// The label is optional
+		auto token = tokens_.cbegin();
+		if (token->type == TokenType::LABEL) label = (token++)->value;
+
+		// Create an object
+		auto instruction = create_instruction(token->value);
+		if (not instruction) throw WrongLineException(std::string(line));
+
+		// Parameters are the operands between separators (including the expressions, e.g. "A==B")
+		const char* parameter_start = nullptr;
+		const char* parameter_end 	= nullptr;
+		TokenType 	parameter_type 	= TokenType::IDENTIFIER;
+		size_t 		parameter_size 	= 0;
+		for (++token; token != tokens_.cend(); ++token) {
+			if (token->type == TokenType::EXPRESSION) {
+				expression = token->value;
+				continue;
+			}
+
+			if (token->type != TokenType::SEPARATOR) {
+				if (not parameter_start) {
+					parameter_start = token->value.data();
+					parameter_type 	= token->type;
+				}
+				parameter_end = token->value.data() + token->value.size();
+				++parameter_size;
+				continue;
 			}
 
-			// Erase the added element
-			line.erase(0, pos + delimiter.length());
+			if (parameter_start) parameters_.push_back(create_operand(
+				std::string_view(parameter_start, parameter_end - parameter_start), 
+				parameter_type, parameter_size, *symbols_));
+			parameter_start = nullptr;
+			parameter_size 	= 0;
 		}
+		if (parameter_start) parameters_.push_back(create_operand(
+			std::string_view(parameter_start, parameter_end - parameter_start), 
+			parameter_type, parameter_size, *symbols_));
 
-		// Push the last token to the result
-		if (pos != 0 and not line.empty()) result.push_back(line);
+		// Save the common variables
+		instruction->parameters = arena_->copy<Operand>(parameters_.begin(), parameters_.end());
+		instruction->label 		= label;
+		if (not label.empty()) instruction->symbol = symbols_->intern(label);
 
-		return result;
+		// Save macro-specific info (only for "MACRO"'s)
+		if (not expression.empty()) 
+			static_cast<Macro*>(instruction)->expression = parse_line(expression);
+
+		return instruction;
 	}
 
-	// FIXME : rewrite using data from Lexer
-	std::shared_ptr<Instruction> Parser::parse_line(std::string line) {
-		std::vector<std::string> 		split = split_line(line, " ", 4);
-		std::vector<std::string> 		parameters;
+	void Parser::parse(void) {
+		if (jobs_ != 1 and raw_->size() > 1) {
+			parse_parallel();
+			return;
+		}
 
-		// Sanity check
-		if (split.size() < 1) throw WrongLineException(line);
+		for (const auto& [filename, file] : *raw_) parse_file(filename, *file);
+	}
 
-		// If the size is > 2, then the instruction contains a label
-		std::string label = (split.size() > 2) ? split.at(0) : "";
-		std::string token = (split.size() > 2) ? split.at(1) : split.at(0);
+	void Parser::parse_file(const std::string& filename, const RawFile& file) {
+		trace::Span span("parser", "parse file", filename);
 
-		// Create an object
-		auto instruction = create_instruction(token);
-		if (not instruction) throw WrongLineException(line);
+		auto parsed_file	= std::make_shared<ParsedFile>();
+		bool is_main 		= false;
+
+		// Load an unchanged file from the cache
+		if (cache_ and cache_->load(file.content(), *parsed_file, is_main, *arena_, *symbols_)) {
+			parsed_->insert(std::make_pair(std::make_pair(filename, is_main), parsed_file));
+			return;
+		}
 
-		// Parse the parameters
-		if (split.size() == 4) {
-			parameters = split_line(split.at(split.size() - 2), ",");
+		for (auto& line : file) {
+			// Parse the line if it's not a comment
+			if (auto instruction = parse_line(line)) {
+				// The label stays, its address is the entry point of the program
+				if (instruction->label == "Main") is_main = true;
 
-			// Save macro-specific info (only for "MACRO"'s)
-			auto& expression = std::dynamic_pointer_cast<Macro>(instruction)->expression;
-			expression = parse_line(split.back());
+				// Save a new parsed instruction
+				parsed_file->push_back(instruction);
+			}
 		}
-		else parameters = split_line(split.at(split.size() - 1), ",");
-		
-		// Save the common variables
-		instruction->parameters = parameters;
-		instruction->label 		= label;
 
-		return instruction;
+		// Store a new filled file
+		if (cache_) cache_->store(file.content(), *parsed_file, is_main);
+		parsed_->insert(std::make_pair(std::make_pair(filename, is_main), parsed_file));
 	}
 
-	void Parser::parse(void) {
-		for (auto file : *raw_) {
-			auto filename		= file.first;
-			auto parsed_file	= std::make_shared<ParsedFile>();
-			bool is_main 		= false;
-
-			for (auto& line : *file.second) {
-				// Remove unnecessary tabs, spaces and comments
-				//remove_comments(line);
-
-				// Parse the line if it's not empty
-				if (not line.empty()) {
-					auto instruction = parse_line(line);
-					if (instruction->label == "Main") {
-						is_main = true;
-						instruction->label.clear();
-					} 
-
-					// Save a new parsed instruction
-					parsed_file->push_back(instruction);
-				}
+	void Parser::parse_parallel(void) {
+		/**
+		 * The result of parsing a single file
+		 */
+		struct Result {
+			std::shared_ptr<Arena> 					arena;
+			std::shared_ptr<SymbolTable> 			symbols;
+			std::shared_ptr<parser::ParsedProgram> 	parsed;
+		};
+
+		// Every file is parsed into its own arena and symbol table, so the workers share nothing
+		ThreadPool 							pool(jobs_);
+		std::vector<std::future<Result>> 	results;
+		for (const auto& file : *raw_) {
+			results.push_back(pool.submit([file, cache = cache_]() {
+				auto program = std::make_shared<RawProgram>();
+				program->insert(file);
+
+				Result result{std::make_shared<Arena>(), std::make_shared<SymbolTable>(), nullptr};
+				result.parsed = Parser(program, result.arena, result.symbols, 1, cache).get();
+				return result;
+			}));
+		}
+
+		// Merge the results in the order of the files, so the IDs don't depend on the timing
+		std::vector<symbols::Id> ids;
+		for (auto& future : results) {
+			auto result = future.get();
+
+			trace::Span span("parser", "merge file");
+			arena_->merge(*result.arena);
+
+			ids.clear();
+			for (symbols::Id id = 0; id < result.symbols->size(); ++id) 
+				ids.push_back(symbols_->intern(result.symbols->name(id)));
+
+			for (const auto& [file, content] : *result.parsed) {
+				for (auto instruction : *content) remap(instruction, ids);
+				parsed_->insert(std::make_pair(file, content));
 			}
+		}
+	}
+
+	void Parser::remap(Instruction* instruction, const std::vector<symbols::Id>& ids) {
+		if (instruction->symbol != symbols::none) instruction->symbol = ids[instruction->symbol];
 
-			// Store a new filled file
-			parsed_->insert(std::make_pair(std::make_pair(filename,is_main), parsed_file));
+		for (auto& parameter : instruction->parameters) 
+			if (parameter.symbol != symbols::none) parameter.symbol = ids[parameter.symbol];
+
+		// The expression of a macro has its own symbols
+		if (instruction->kind == Instruction::Kind::MACRO) {
+			auto expression = static_cast<Macro*>(instruction)->expression;
+			if (expression) remap(expression, ids);
 		}
 	}
 
@@ -124,35 +199,78 @@ namespace mmix {
 		return parsed_;
 	}
 
-	std::shared_ptr<Instruction> Parser::create_instruction(const std::string& token) {
-		InstructionFactory 	factory;
+	Instruction* Parser::create_instruction(std::string_view token) {
+		InstructionFactory 	factory(*arena_);
+
+		// Classify the token with a single lookup
+		auto keyword = keywords::find(token);
+		if (not keyword) return nullptr;
 
 		// Create an object depending on the token
-		if (std::find(macros.begin(), macros.end(), token) != macros.end()) {
-			auto concrete_instruction 	= factory.create_macro();
-			concrete_instruction->type 	= token;
-				
-			return concrete_instruction;
-		}
-		else if (std::find(directives.begin(), directives.end(), token) != directives.end()) {
-			auto concrete_instruction = factory.create_directive();
-			concrete_instruction->directive = token;
+		switch (keyword->type) {
+			case keywords::Type::MACRO: {
+				auto concrete_instruction 	= factory.create_macro();
+				concrete_instruction->type 	= token;
+					
+				return concrete_instruction;
+			}
+			case keywords::Type::DIRECTIVE: {
+				auto concrete_instruction = factory.create_directive();
+				concrete_instruction->directive = token;
 
-			return concrete_instruction;
-		}
-		else if (mnemonics.find(token) != mnemonics.end()) {
-			auto concrete_instruction = factory.create_mnemonic(); 
-			concrete_instruction->mnemonic = token;
-	
-			return concrete_instruction;
+				return concrete_instruction;
+			}
+			case keywords::Type::MNEMONIC: {
+				auto concrete_instruction = factory.create_mnemonic(); 
+				concrete_instruction->mnemonic = token;
+		
+				return concrete_instruction;
+			}
+			case keywords::Type::SIZE: {
+				auto concrete_instruction = factory.create_allocator();
+				concrete_instruction->size = token;
+
+				return concrete_instruction;
+			}
 		}
-		else if (sizes.find(token) != sizes.end()) {
-			auto concrete_instruction = factory.create_allocator();
-			concrete_instruction->size = token;
 
-			return concrete_instruction;
+		return nullptr;
+	}
+
+	Operand Parser::create_operand(std::string_view text, 
+		TokenType type, 
+		size_t size, 
+		SymbolTable& symbols) {
+		Operand operand;
+		operand.text = text;
+
+		// Everything which consists of several tokens is an expression
+		if (size != 1) return operand;
+
+		switch (type) {
+			case TokenType::IDENTIFIER:
+				operand.type 	= Operand::Type::SYMBOL;
+				operand.symbol 	= symbols.intern(text);
+				break;
+			case TokenType::REGISTER: 	operand.type = Operand::Type::REGISTER; break;
+			case TokenType::IMMEDIATE: 	operand.type = Operand::Type::IMMEDIATE; break;
+			case TokenType::STRING: 	operand.type = Operand::Type::STRING; break;
+			default: 					break;
 		}
-		else return std::shared_ptr<Instruction>();
+
+		// Numbers are decoded once, the compiler uses the values
+		if (operand.type == Operand::Type::REGISTER or operand.type == Operand::Type::IMMEDIATE) 
+			operand.resolved = Lexer::decode(text, operand.value);
+
+		return operand;
+	}
+
+	Operand Parser::create_operand(std::string_view text, SymbolTable& symbols) {
+		thread_local lexer::Tokens tokens;
+
+		Lexer::tokenize_operands(text, tokens);
+		if (tokens.empty()) return create_operand(text, TokenType::IDENTIFIER, 0, symbols);
+		return create_operand(text, tokens.front().type, tokens.size(), symbols);
 	}
 
 	std::string Parser::replace_substr(std::string str, 
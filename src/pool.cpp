@@ -0,0 +1,110 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "pool.h"
+
+namespace mmix {
+	namespace {
+		thread_local const ThreadPool* 	owner 	= nullptr;	// The pool of the current worker
+		thread_local size_t 			worker 	= 0;		// The index of the current worker
+	} // namespace
+
+	ThreadPool::ThreadPool(size_t size) {
+		if (size == 0) size = std::max(1u, std::thread::hardware_concurrency());
+
+		for (size_t index = 0; index < size; ++index) queues_.push_back(std::make_unique<Queue>());
+		for (size_t index = 0; index < size; ++index) 
+			workers_.emplace_back(&ThreadPool::work, this, index);
+	}
+
+	ThreadPool::~ThreadPool(void) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopped_ = true;
+		}
+		condition_.notify_all();
+
+		for (auto& worker : workers_) worker.join();
+	}
+
+	void ThreadPool::push(std::function<void()> task) {
+		// The tasks from outside are spread over the workers
+		auto index = owner == this ? worker : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+		{
+			std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+			queues_[index]->tasks.push_back(std::move(task));
+		}
+
+		// The task is counted after it's queued, so a reserved task can always be found
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++pending_;
+		}
+		condition_.notify_one();
+	}
+
+	std::function<void()> ThreadPool::take(size_t index) {
+		while (true) {
+			// The oldest task of the own queue
+			{
+				auto& queue = *queues_[index];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (not queue.tasks.empty()) {
+					auto task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+					return task;
+				}
+			}
+
+			// The latest task of another queue
+			for (size_t offset = 1; offset < queues_.size(); ++offset) {
+				auto& queue = *queues_[(index + offset) % queues_.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (not queue.tasks.empty()) {
+					auto task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+					return task;
+				}
+			}
+		}
+	}
+
+	void ThreadPool::work(size_t index) {
+		owner 	= this;
+		worker 	= index;
+
+		while (true) {
+			// Reserve a task
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				condition_.wait(lock, [this]() { return stopped_ or pending_ != 0; });
+
+				// Leave only when there is nothing to do
+				if (pending_ == 0) return;
+				--pending_;
+			}
+
+			take(index)();
+		}
+	}
+
+	size_t ThreadPool::size(void) const {
+		return workers_.size();
+	}
+} // namespace mmix
@@ -25,195 +25,320 @@ using mmix::exceptions::preprocessor::UnknownDirectiveException;
 using mmix::exceptions::preprocessor::BlockNotFoundException;
 using mmix::exceptions::preprocessor::LabelNotFoundException;
 using mmix::macroprocessor::MacroprocessedProgram;
+using mmix::exceptions::compiler::WrongOperandException;
 
 namespace mmix {
-	Preprocessor::Preprocessor(std::shared_ptr<MacroprocessedProgram> program) :
-	program_{std::make_shared<preprocessor::PreprocessedProgram>()},
-	label_table_{std::make_shared<LabelTable>()},
-	block_table_{std::make_shared<BlockTable>()} {
-		// Copy the elements from the  source
-		for (auto element : *program)
-			if (element) 
-				program_->push_back(element);
-
-		// Preprocess the program
-		relocate_instructions();
+	Preprocessor::Preprocessor(std::shared_ptr<MacroprocessedProgram> program, 
+	std::shared_ptr<Arena> arena, 
+	std::shared_ptr<SymbolTable> symbols, 
+	bool streamed) :
+	block_table_{std::make_shared<BlockTable>()},
+	program_{std::make_shared<MacroprocessedProgram>()},
+	image_{std::make_shared<preprocessor::PreprocessedProgram>()},
+	label_table_{std::make_shared<LabelTable>(symbols->size(), nullptr)},
+	arena_{arena},
+	symbols_{symbols} {
+		// Copy the elements from the  source (and count the labels)
+		for (auto element : *program) {
+			if (not element) continue;
+
+			program_->push_back(element);
+			if (element->symbol != symbols::none) ++labels_;
+		}
+
+		// Preprocess the program (a streamed one is placed later)
 		fill_tables();
 		preprocess();
+		if (not streamed) relocate_instructions();
 	}
 
-	void Preprocessor::create_block(std::string label, uint64_t address) {
-		try {
-			find_block(label);
-			throw BlockExistsException(label);
-		}
-		catch (const BlockNotFoundException& e) {
-			block_table_->push_back(Block{label, address});
+	uint32_t Preprocessor::create_block(std::string_view label, uint64_t address, uint32_t parent) {
+		auto [iterator, inserted] = block_ids_.emplace(std::string(label), block_table_->size());
+		if (inserted) {
+			Block block;
+			block.label 	= iterator->first;
+			block.origin 	= address;
+			block.parent 	= parent;
+			block_table_->push_back(block);
 		}
+
+		return iterator->second;
 	}
 
-	Preprocessor::Block& Preprocessor::find_block(std::string& label) {
+	Preprocessor::Block& Preprocessor::find_block(std::string_view label) {
 		//  Try to find a block and return it
-		for (Block& block : *block_table_)
-			if (block.label == label) return block;
+		auto iterator = block_ids_.find(std::string(label));
+		if (iterator != block_ids_.end()) return block_table_->at(iterator->second);
 
-		throw BlockNotFoundException(label);
+		throw BlockNotFoundException(std::string(label));
 	}
 
-	void Preprocessor::update_block_addresses(Block& block) {
-		for (uint32_t index = block.start; index <= block.end; ++index) {
-			auto instruction = std::dynamic_pointer_cast<Allocator>(program_->at(index));
+	void Preprocessor::relocate_blocks(void) {
+		if (block_table_->empty()) return;
 
-			// If there is no label just get to the next instruction
-			if (instruction->label.empty()) continue;
-			// Ignore data allocation labels
-			if (not instruction->size.empty()) continue;
-			
-			auto entry = find_label(instruction->label);
-			entry.second = std::to_string(block.origin + (index - block.start));
+		trace::Span span("preprocessor", "relocate blocks");
+
+		const uint64_t size = program_->size();
+		const auto& blocks 	= *block_table_;
+
+		// The block of every instruction and the blocks placed before every instruction
+		std::vector<uint32_t> owners(size, no_block);
+		std::vector<uint32_t> anchors(size + 1, no_block);
+		std::vector<uint32_t> next(blocks.size(), no_block);
+		for (uint32_t index = blocks.size(); index-- > 0;) {
+			const auto& block = blocks[index];
+			if (not block.opened or not block.closed or block.origin > size) 
+				throw BadBlockException(block.label);
+
+			for (auto address = block.start; address <= block.end; ++address) {
+				if (owners[address] != no_block) throw BadBlockException(block.label);
+				owners[address] = index;
+			}
+
+			next[index] 			= anchors[block.origin];
+			anchors[block.origin] 	= index;
 		}
-	}
 
-	void Preprocessor::emplace_block(Block& block) {
-		auto block_origin 	= program_->begin() + block.origin;
-		auto block_iterator = program_->begin() + block.start;
-		auto block_end 		= program_->begin() + block.end;
+		/**
+		 * A range of the program being copied
+		 */
+		struct Frame {
+			uint32_t block;			// The block of the range (no_block for the whole program)
+			uint64_t address;		// The current instruction
+			uint64_t end;			// The address after the range ("USE" can be right before "ENDBLOCK")
+			uint32_t anchor;		// The next block to place before the instruction
+		};
+
+		// Copy the ranges depth-first : the blocks used in the range at an instruction 
+		// go before it, the instructions of other blocks are skipped
+		macroprocessor::MacroprocessedProgram 	program;
+		std::vector<Frame> 						frames{Frame{no_block, 0, size, anchors[0]}};
+		std::vector<bool> 						placed(blocks.size(), false);
+		program.reserve(size);
+		while (not frames.empty()) {
+			auto& frame = frames.back();
+			if (frame.address > frame.end) {
+				frames.pop_back();
+				continue;
+			}
+
+			// Place the next block anchored at the instruction (a block without "USE" is anchored at its start)
+			if (frame.anchor != no_block) {
+				auto index 		= frame.anchor;
+				frame.anchor 	= next[index];
+				if (placed[index] or blocks[index].parent != frame.block) continue;
 
-		// Move instructions of the block
-		while (block_iterator <= block_end) {
-			// Insert an instruction into the right place
-			program_->insert(block_origin, *block_iterator);
+				placed[index] = true;
+				frames.push_back(Frame{index, blocks[index].start, blocks[index].end + 1, 
+					anchors[blocks[index].start]});
+				continue;
+			}
 
-			// Move to the next position of the program
-			++block_origin;
-			++block_iterator;
+			// The labels of the block get their addresses when the program is compiled
+			if (frame.address < size and owners[frame.address] == frame.block) 
+				program.push_back((*program_)[frame.address]);
 
-			// Erase the instruction after insertion
-			program_->erase(block_iterator);
+			++frame.address;
+			frame.anchor = frame.address <= frame.end ? anchors[frame.address] : no_block;
 		}
+
+		// A block can't be placed if it's used inside itself or inside a block which is never placed
+		for (uint32_t index = 0; index < blocks.size(); ++index) 
+			if (not placed[index]) throw BadBlockException(blocks[index].label);
+
+		program_->swap(program);
 	}
 
-	void Preprocessor::create_label(std::string& label, std::string& expression) {
-		// Insert a new label
-		try {
-			find_label(label);
-		}
-		catch (const LabelNotFoundException& e) {
-			label_table_->insert(Label(label, expression));
-		}
+	void Preprocessor::create_label(symbols::Id label, const Operand* expression) {
+		// Unlabeled expressions can't be referenced
+		if (label == symbols::none) return;
+
+		// Insert a new label (the first definition is kept)
+		auto& entry = label_table_->at(label);
+		if (not entry) entry = expression;
 	}
 
-	Preprocessor::Label& Preprocessor::find_label(std::string& label) {
-		auto iterator = label_table_->find(label);
-		if (iterator != label_table_->end()) return *iterator;
+	Preprocessor::Label& Preprocessor::find_label(symbols::Id label) {
+		if (label != symbols::none and label_table_->at(label)) return label_table_->at(label);
 			
-		// Throw an exception if the block was not found
-		throw LabelNotFoundException(label);
+		// Throw an exception if the label was not found
+		throw LabelNotFoundException(std::string(label != symbols::none ? symbols_->name(label) : ""));
 	}
 
-	void Preprocessor::replace_labels(std::shared_ptr<Instruction>& instruction) {
+	void Preprocessor::replace_labels(Instruction* instruction) {
 		// Iterate over parameters
 		for (auto& parameter : instruction->parameters) {
-			auto iterator = label_table_->find(parameter);
+			if (parameter.type != Operand::Type::SYMBOL) continue;
 
 			// If there is a label, change it to the expression associated with it
-			if (iterator != label_table_->end())
-				parameter = iterator->second;
+			if (auto expression = (*label_table_)[parameter.symbol])
+				parameter = *expression;
 		}
 	}
 
 	void Preprocessor::fill_tables(void) {
-		// Iterate over addresses
-		for (uint64_t address = 0; address != program_->size();) {
-			auto instruction = std::dynamic_pointer_cast<Directive>(program_->at(address));
+		trace::Span span("preprocessor", "fill tables");
 
-			// Skip if the directive variable is empty
-			if (not instruction) {
-				++address;
+		// The instructions are moved to the front in a single pass, the addresses
+		// of the blocks are the positions in the compacted program
+		uint64_t 				address = 0;
+		std::vector<uint32_t> 	open;		// The blocks between "BLOCK" and "ENDBLOCK"
+		for (auto element : *program_) {
+			// Keep everything except directives
+			if (element->kind != Instruction::Kind::DIRECTIVE) {
+				(*program_)[address++] = element;
 				continue;
 			}
 
+			auto instruction 	= static_cast<Directive*>(element);
+
 			auto directive 		= instruction->directive;
-			auto label			= instruction->label;
-			auto parameter		= instruction->parameters.at(0);
+			auto& operand		= instruction->parameters.at(0);
+			auto parameter		= operand.text;
+
+			// Keep relocations for the memory image
+			if (directive == "LOC") {
+				(*program_)[address++] = element;
+				continue;
+			}
 
 			// Process directives if it's found
 			if (directive == "USE") {
-				try {
-					auto& block = find_block(parameter);
-					block.label = label;
-					block.origin = address;
-				}
-				catch (const BlockNotFoundException& e){
-					create_block(parameter, address);
-				}
+				auto& block 	= (*block_table_)[create_block(parameter, address, parent(open))];
+				block.origin 	= address;
+				block.parent 	= parent(open);
 			}
 			else if (directive == "BLOCK") {
-				try {
-					find_block(parameter);
-				}
-				catch (const BlockNotFoundException& e){
-					create_block(parameter, address);
-				}
-
-				auto& block = find_block(parameter);
-				block.start = (address);
+				// A block without "USE" stays in its place
+				auto index 		= create_block(parameter, address, parent(open));
+				auto& block 	= (*block_table_)[index];
+				block.start 	= address;
+				block.opened 	= true;
+				open.push_back(index);
 			}
 			else if (directive == "ENDBLOCK") {
 				auto& block = find_block(parameter);
-				block.end = (address - 1);
-
-				if (block.start > block.end) 
+				if (not block.opened or block.start >= address or open.empty() or 
+					&(*block_table_)[open.back()] != &block) 
 					throw BadBlockException(block.label);
+
+				block.end 		= address - 1;
+				block.closed 	= true;
+				open.pop_back();
 			}
 			else if (directive == "IS")
-				create_label(label, parameter);
+				create_label(instruction->symbol, &operand);
 			else 
-				throw UnknownDirectiveException(directive);
-
-			// Remove the preprocessed data
-			program_->erase(program_->begin() + address);
+				throw UnknownDirectiveException(std::string(directive));
 		}
+
+		// Remove the preprocessed data
+		program_->resize(address);
 	}
 
 	void Preprocessor::preprocess(void) {
-		// Iterate over blocks
-		for (auto block : *block_table_) {
-			emplace_block(block);
-			update_block_addresses(block);
-		}
+		// Move the blocks
+		relocate_blocks();
+	}
+
+	bool Preprocessor::is_location(const Instruction* instruction) {
+		return instruction->kind == Instruction::Kind::DIRECTIVE and 
+			static_cast<const Directive*>(instruction)->directive == "LOC";
+	}
 
-		// Change labels to data
-		for (auto& instruction : *program_) replace_labels(instruction);
+	uint64_t Preprocessor::location(const Operand& operand) {
+		// Move to the address of a segment or to the given one (decoded by the parser)
+		uint64_t address;
+		if (auto segment = constants::find_segment(operand.text)) return segment->second;
+		if (operand.resolved) return operand.value;
+		if (Lexer::decode(operand.text, address)) return address;
+
+		throw WrongOperandException(std::string(operand.text));
 	}
 
-	void Preprocessor::relocate_instructions(void) {
-		// Iterate over addresses
-		for (uint64_t address = 0; address < program_->size(); ++address) {
-			auto instruction = std::dynamic_pointer_cast<Directive>(program_->at(address));
+	void Preprocessor::relocate_instructions(preprocessor::Stream* stream) {
+		trace::Span span("preprocessor", "relocate instructions");
 
-			// Skip if the directive variable is empty
-			if (not instruction) {
+		// The relocations go first : the instructions can be streamed in the order
+		// of the program only if no "LOC" moves back into the placed ones
+		std::vector<uint64_t> 	locations;
+		uint64_t 				address = image_->address();
+		bool 					ordered = true;
+		for (auto element : *program_) {
+			if (not is_location(element)) {
 				++address;
 				continue;
 			}
 
-			// Relocate a block of memory
-			if (instruction->directive == "LOC") {
-				// FIXME : throw an exception when a size of a parameter vector is != 1
-				auto parameter	= instruction->parameters.at(0);
-				auto offset = (parameter == "Data_Segment") ? constants::data_segment : stoi(parameter);
-
-				// Fill space to create an offset
-				for (auto iterator = program_->begin() + address; 
-						iterator != program_->begin() + offset; 
-						++iterator) 
-					program_->insert(iterator, std::make_shared<Mnemonic>());
+			// FIXME : throw an exception when a size of a parameter vector is != 1
+			replace_labels(element);
+			auto target = location(element->parameters.at(0));
+			if (target < address) ordered = false;
+			locations.push_back(address = target);
+		}
+
+		// Change labels to data and place everything except relocations into the image
+		preprocessor::Chunk chunk{image_->address(), false, {}};
+		auto next = locations.cbegin();
+		for (auto element : *program_) {
+			if (is_location(element)) {
+				// The image continues the extent if "LOC" points right after it
+				bool extent = *next != image_->address();
+				image_->locate(*next++);
+				if (not stream or not ordered) continue;
+
+				// An empty chunk just moves to the new address
+				if (not chunk.instructions.empty()) {
+					if (not stream->push(std::move(chunk))) return;
+					chunk = preprocessor::Chunk{image_->address(), extent, {}};
+				}
+				else {
+					chunk.origin = image_->address();
+					chunk.extent = chunk.extent or extent;
+				}
+				continue;
+			}
+
+			replace_labels(element);
+			image_->push_back(element);
+			if (not stream or not ordered) continue;
+
+			chunk.instructions.push_back(element);
+			if (chunk.instructions.size() == preprocessor::chunk_size) {
+				if (not stream->push(std::move(chunk))) return;
+				chunk = preprocessor::Chunk{image_->address(), false, {}};
 			}
 		}
+		if (not stream) return;
+
+		// The extents of an unordered program are sent once the image is complete
+		if (ordered) {
+			// The image keeps the last extent, even if it's empty
+			if (not chunk.instructions.empty() or chunk.extent) stream->push(std::move(chunk));
+			return;
+		}
+		for (const auto& [origin, extent] : *image_) 
+			if (not stream->push(preprocessor::Chunk{origin, true, extent})) return;
+	}
+
+	void Preprocessor::stream(preprocessor::Stream& stream) {
+		try {
+			relocate_instructions(&stream);
+		}
+		catch (...) {
+			// The compiler stops waiting for the chunks
+			stream.close();
+			throw;
+		}
+
+		stream.close();
 	}
 
 	std::shared_ptr<preprocessor::PreprocessedProgram> Preprocessor::get(void) {
-		return program_;
+		return image_;
+	}
+
+	size_t Preprocessor::labels(void) const {
+		return labels_;
 	}
 } // namespace mmix
\ No newline at end of file
@@ -0,0 +1,333 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "server.h"
+
+// Include C++ STL headers
+#include <sstream>
+#include <stdexcept>
+#include <filesystem>
+#include <cstring>
+
+// Include POSIX headers
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <csignal>
+#endif // _WIN32
+
+// Include project headers
+#include "options.h"
+
+namespace mmix {
+	namespace server {
+		namespace {
+			/**
+			 * Append a big-endian tetrabyte
+			 * @param buffer the buffer to append to
+			 * @param value the value
+			 */
+			void put(std::string& buffer, uint32_t value) {
+				for (int byte = 3; byte >= 0; --byte) buffer.push_back(static_cast<char>(value >> (byte * 8)));
+			}
+
+			/**
+			 * Append a string with its length
+			 * @param buffer the buffer to append to
+			 * @param value the string
+			 */
+			void put(std::string& buffer, std::string_view value) {
+				put(buffer, static_cast<uint32_t>(value.size()));
+				buffer.append(value);
+			}
+
+			/**
+			 * Take a big-endian tetrabyte
+			 * @param data the remaining data (moved past the value)
+			 * @param value the value to fill
+			 * @return false if the data is too short
+			 */
+			bool take(std::string_view& data, uint32_t& value) {
+				if (data.size() < sizeof(uint32_t)) return false;
+
+				value = 0;
+				for (size_t byte = 0; byte < sizeof(uint32_t); ++byte) 
+					value = (value << 8) | static_cast<uint8_t>(data[byte]);
+				data.remove_prefix(sizeof(uint32_t));
+				return true;
+			}
+
+			/**
+			 * Take a string with its length
+			 * @param data the remaining data (moved past the string)
+			 * @param value the string to fill
+			 * @return false if the data is too short
+			 */
+			bool take(std::string_view& data, std::string& value) {
+				uint32_t size;
+				if (not take(data, size) or data.size() < size) return false;
+
+				value = std::string(data.substr(0, size));
+				data.remove_prefix(size);
+				return true;
+			}
+
+#ifndef _WIN32
+			/**
+			 * Send a message
+			 * @param socket the connected socket
+			 * @param payload the payload of the message
+			 * @return false if the connection was lost
+			 */
+			bool send_message(int socket, std::string_view payload) {
+				std::string buffer;
+				buffer.reserve(payload.size() + sizeof(uint32_t));
+				put(buffer, payload);
+
+				for (size_t sent = 0; sent < buffer.size(); ) {
+					auto result = ::write(socket, buffer.data() + sent, buffer.size() - sent);
+					if (result <= 0) return false;
+					sent += result;
+				}
+				return true;
+			}
+
+			/**
+			 * Receive a message
+			 * @param socket the connected socket
+			 * @param payload the payload to fill
+			 * @return false if the connection was lost or the message is too big
+			 */
+			bool receive_message(int socket, std::string& payload) {
+				auto receive = [socket](char* data, size_t size) {
+					for (size_t received = 0; received < size; ) {
+						auto result = ::read(socket, data + received, size - received);
+						if (result <= 0) return false;
+						received += result;
+					}
+					return true;
+				};
+
+				char header[sizeof(uint32_t)];
+				if (not receive(header, sizeof(header))) return false;
+
+				uint32_t size;
+				std::string_view data(header, sizeof(header));
+				take(data, size);
+
+				// The size comes from the client, it's checked before anything is allocated
+				if (size > max_message) return false;
+				payload.resize(size);
+				return receive(payload.data(), size);
+			}
+
+			/**
+			 * Get the address of the socket
+			 * @param path the path of the socket
+			 * @return the address
+			 */
+			sockaddr_un address_of(const std::string& path) {
+				sockaddr_un address{};
+				if (path.size() >= sizeof(address.sun_path)) 
+					throw std::invalid_argument("The socket path is too long!");
+
+				address.sun_family = AF_UNIX;
+				std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+				return address;
+			}
+#endif // _WIN32
+		} // namespace
+
+		std::string encode(const Request& request) {
+			std::string buffer;
+			put(buffer, request.directory);
+
+			put(buffer, static_cast<uint32_t>(request.arguments.size()));
+			for (const auto& argument : request.arguments) put(buffer, argument);
+
+			put(buffer, static_cast<uint32_t>(request.sources.size()));
+			for (const auto& [name, content] : request.sources) {
+				put(buffer, name);
+				put(buffer, content);
+			}
+
+			return buffer;
+		}
+
+		std::string encode(const Response& response) {
+			std::string buffer;
+			put(buffer, static_cast<uint32_t>(response.status));
+			put(buffer, response.output);
+			put(buffer, response.error);
+
+			return buffer;
+		}
+
+		bool decode(std::string_view data, Request& request) {
+			// Every string takes at least its length, so a bigger count is broken
+			uint32_t count;
+			if (not take(data, request.directory) or not take(data, count)) return false;
+			if (count > data.size() / sizeof(uint32_t)) return false;
+
+			request.arguments.resize(count);
+			for (auto& argument : request.arguments) 
+				if (not take(data, argument)) return false;
+
+			if (not take(data, count) or count > data.size() / (2 * sizeof(uint32_t))) return false;
+			request.sources.resize(count);
+			for (auto& [name, content] : request.sources) 
+				if (not take(data, name) or not take(data, content)) return false;
+
+			return data.empty();
+		}
+
+		bool decode(std::string_view data, Response& response) {
+			uint32_t status;
+			if (not take(data, status) or not take(data, response.output) or not take(data, response.error)) 
+				return false;
+
+			response.status = static_cast<int32_t>(status);
+			return data.empty();
+		}
+
+		Response submit(const std::string& path, const Request& request) {
+#ifndef _WIN32
+			auto address = address_of(path);
+
+			// Check if the server is running
+			int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (descriptor == -1 or connect(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+				if (descriptor != -1) close(descriptor);
+				throw std::invalid_argument("The server is not running!");
+			}
+
+			Response response;
+			std::string payload;
+			bool received = send_message(descriptor, encode(request)) and 
+				receive_message(descriptor, payload) and decode(payload, response);
+			close(descriptor);
+
+			if (not received) throw std::invalid_argument("The server closed the connection!");
+			return response;
+#else
+			throw std::invalid_argument("Unix sockets are not supported!");
+#endif // _WIN32
+		}
+	} // namespace server
+
+	Server::Server(const std::string& path, const std::string& cache) :
+		path_{std::filesystem::absolute(path).string()},
+		cache_{cache.empty() ? cache : std::filesystem::absolute(cache).string()},
+		description_{options::describe()} {
+#ifndef _WIN32
+		auto address = server::address_of(path_);
+
+		// A client which disconnects early mustn't stop the server
+		std::signal(SIGPIPE, SIG_IGN);
+
+		// Replace a socket left by a server which didn't stop properly
+		unlink(path_.c_str());
+		socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (socket_ == -1 or 
+			bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 or 
+			listen(socket_, SOMAXCONN) == -1) {
+			if (socket_ != -1) close(socket_);
+			throw std::invalid_argument("The socket is not correct!");
+		}
+#else
+		throw std::invalid_argument("Unix sockets are not supported!");
+#endif // _WIN32
+	}
+
+	Server::~Server() {
+#ifndef _WIN32
+		if (socket_ != -1) {
+			close(socket_);
+			unlink(path_.c_str());
+		}
+#endif // _WIN32
+	}
+
+	server::Response Server::handle(const server::Request& request) {
+		server::Response response;
+		std::stringstream output;
+
+		try {
+			// The paths of the build are relative to the directory of the client
+			std::error_code error;
+			if (not std::filesystem::is_directory(request.directory, error)) 
+				throw std::invalid_argument("The working directory is not correct!");
+
+			auto values = options::parse(request.arguments, description_);
+			if (values.count("help")) output << "Usage: options_description [options]" << std::endl << description_;
+			else {
+				auto application = options::configure(values);
+				application->set_directory(request.directory);
+				if (not values.count("cache-dir") and not cache_.empty()) application->set_cache(cache_);
+				for (const auto& [name, content] : request.sources) application->add_source(name, content);
+
+				application->set_report(output);
+				application->start();
+			}
+		}
+		catch (const std::exception& exception) {
+			response.status = 1;
+			response.error 	= exception.what();
+		}
+
+		response.output = output.str();
+		return response;
+	}
+
+	void Server::run(void) {
+#ifndef _WIN32
+		// The builds run one by one : the trace and the statistics belong to the process
+		while (true) {
+			int connection = accept(socket_, nullptr, nullptr);
+			if (connection == -1) continue;
+
+			// A client which stops in the middle of a message is dropped instead of blocking the others
+			timeval timeout{server::timeout, 0};
+			setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+			// A broken connection (e.g. the server runs out of memory) drops only its build
+			bool stop = false;
+			try {
+				std::string payload;
+				server::Request request;
+				if (server::receive_message(connection, payload) and server::decode(payload, request)) {
+					// Stop after the reply, so the client knows the server is gone
+					stop = request.arguments.size() == 1 and request.arguments.front() == server::shutdown;
+					auto response = stop ? server::Response() : handle(request);
+					server::send_message(connection, server::encode(response));
+				}
+			}
+			catch (const std::exception&) {
+				// The connection is just closed
+			}
+			close(connection);
+
+			if (stop) return;
+		}
+#endif // _WIN32
+	}
+} // namespace mmix
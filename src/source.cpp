@@ -0,0 +1,138 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "source.h"
+
+// Include C++ STL headers
+#include <fstream>
+#include <sstream>
+#include <cstring>
+
+// Include POSIX headers
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace mmix {
+	SourceFile::SourceFile(const std::string& filename) {
+		map(filename);
+		split();
+	}
+
+	std::shared_ptr<SourceFile> SourceFile::from_content(std::string content) {
+		std::shared_ptr<SourceFile> file(new SourceFile());
+
+		file->buffer_ 	= std::move(content);
+		file->data_ 	= file->buffer_.data();
+		file->size_ 	= file->buffer_.size();
+		file->split();
+
+		return file;
+	}
+
+	std::shared_ptr<SourceFile> SourceFile::from_view(std::string_view content) {
+		std::shared_ptr<SourceFile> file(new SourceFile());
+
+		file->data_ = content.data();
+		file->size_ = content.size();
+		file->split();
+
+		return file;
+	}
+
+	SourceFile::~SourceFile() {
+#ifndef _WIN32
+		if (mapped_) 
+			munmap(const_cast<char*>(data_), size_);
+#endif // _WIN32
+	}
+
+	void SourceFile::map(const std::string& filename) {
+#ifndef _WIN32
+		int descriptor = open(filename.c_str(), O_RDONLY);
+		struct stat status;
+
+		// Check if the file was opened
+		if (descriptor == -1 or fstat(descriptor, &status) == -1) {
+			if (descriptor != -1) close(descriptor);
+			throw std::ifstream::failure("File was not opened!");
+		}
+
+		// Empty files can't be mapped
+		size_ = status.st_size;
+		if (size_ != 0) {
+			void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (address != MAP_FAILED) {
+				madvise(address, size_, MADV_SEQUENTIAL);
+				data_ 	= static_cast<const char*>(address);
+				mapped_ = true;
+			}
+		}
+		close(descriptor);
+
+		// Fall back to reading if the file is not mappable (e.g. a pipe reports the size 0)
+		if (data_ != nullptr or (size_ == 0 and S_ISREG(status.st_mode))) return;
+#endif // _WIN32
+		std::ifstream input_stream(filename, std::ios::binary);
+		std::stringstream content;
+
+		// Check if the file was opened
+		if (!input_stream.is_open())
+			throw std::ifstream::failure("File was not opened!");
+
+		// Read the whole file
+		content << input_stream.rdbuf();
+		buffer_ = content.str();
+		data_ 	= buffer_.data();
+		size_ 	= buffer_.size();
+	}
+
+	void SourceFile::split(void) {
+		const char* position 	= data_;
+		const char* end 		= data_ + size_;
+
+		// Store every non-empty line of the program
+		while (position < end) {
+			auto line_end = static_cast<const char*>(std::memchr(position, '\n', end - position));
+			if (not line_end) line_end = end;
+
+			if (line_end != position) lines_.emplace_back(position, line_end - position);
+			position = line_end + 1;
+		}
+	}
+
+	std::string_view SourceFile::content(void) const {
+		return std::string_view(data_, size_);
+	}
+
+	SourceFile::const_iterator SourceFile::begin(void) const {
+		return lines_.begin();
+	}
+
+	SourceFile::const_iterator SourceFile::end(void) const {
+		return lines_.end();
+	}
+
+	size_t SourceFile::size(void) const {
+		return lines_.size();
+	}
+} // namespace mmix
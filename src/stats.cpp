@@ -0,0 +1,117 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "stats.h"
+
+// Include C++ STL headers
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <ctime>
+
+// Include POSIX headers
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif // _WIN32
+
+namespace mmix {
+	namespace stats {
+		std::atomic<uint64_t> allocations{0};
+		std::atomic<uint32_t> counting{0};
+
+		Usage now(void) {
+			Usage usage{};
+
+			usage.wall 			= std::chrono::duration<double>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+			usage.cpu 			= static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+			usage.allocations 	= allocations.load(std::memory_order_relaxed);
+
+#ifndef _WIN32
+			// The peak is reported in kilobytes
+			rusage resources;
+			if (getrusage(RUSAGE_SELF, &resources) == 0) 
+				usage.peak_rss = static_cast<uint64_t>(resources.ru_maxrss) * 1024;
+#endif // _WIN32
+
+			return usage;
+		}
+	} // namespace stats
+
+	Statistics::Statistics(void) {
+		stats::counting.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Statistics::~Statistics() {
+		stats::counting.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void Statistics::record(const std::string& name, const stats::Usage& start) {
+		auto end = stats::now();
+		stages_.push_back(Stage{name, 
+			end.wall - start.wall, 
+			end.cpu - start.cpu, 
+			end.peak_rss, 
+			end.allocations - start.allocations});
+	}
+
+	void Statistics::count(const std::string& name, uint64_t value) {
+		counters_.emplace_back(name, value);
+	}
+
+	void Statistics::report(std::ostream& stream, bool json) const {
+		if (json) {
+			stream << "{" << std::endl << "  \"scope\": \"process\"," << std::endl << "  \"stages\": [" << std::endl;
+			for (auto it = stages_.begin(); it != stages_.end(); ++it) {
+				stream << "    {\"name\": \"" << it->name << "\""
+					<< ", \"wall_seconds\": " << it->wall
+					<< ", \"cpu_seconds\": " << it->cpu
+					<< ", \"peak_rss_bytes\": " << it->peak_rss
+					<< ", \"allocations\": " << it->allocations
+					<< "}" << (std::next(it) == stages_.end() ? "" : ",") << std::endl;
+			}
+			stream << "  ]," << std::endl << "  \"counters\": {" << std::endl;
+			for (auto it = counters_.begin(); it != counters_.end(); ++it) {
+				stream << "    \"" << it->first << "\": " << it->second 
+					<< (std::next(it) == counters_.end() ? "" : ",") << std::endl;
+			}
+			stream << "  }" << std::endl << "}" << std::endl;
+			return;
+		}
+
+		stream << std::left << std::setw(16) << "stage" << std::right 
+			<< std::setw(12) << "wall ms" 
+			<< std::setw(12) << "cpu ms" 
+			<< std::setw(14) << "peak rss KiB" 
+			<< std::setw(14) << "allocations" << std::endl;
+		for (const auto& stage : stages_) {
+			stream << std::left << std::setw(16) << stage.name << std::right << std::fixed 
+				<< std::setprecision(3)
+				<< std::setw(12) << stage.wall * 1000 
+				<< std::setw(12) << stage.cpu * 1000 
+				<< std::setw(14) << stage.peak_rss / 1024 
+				<< std::setw(14) << stage.allocations << std::endl;
+		}
+		stream << "(cpu, peak rss and allocations are counted for the whole process)" << std::endl;
+
+		stream << std::endl;
+		for (const auto& [name, value] : counters_) 
+			stream << std::left << std::setw(16) << name << value << std::endl;
+	}
+} // namespace mmix
@@ -0,0 +1,48 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "symbols.h"
+
+namespace mmix {
+	symbols::Id SymbolTable::intern(std::string_view name) {
+		auto iterator = ids_.find(name);
+		if (iterator != ids_.end()) return iterator->second;
+
+		// Keep a copy of the name, the source can be freed before the table
+		auto id 	= static_cast<symbols::Id>(names_.size());
+		auto copy 	= storage_.copy(name);
+		names_.push_back(copy);
+		ids_.emplace(copy, id);
+
+		return id;
+	}
+
+	symbols::Id SymbolTable::find(std::string_view name) const {
+		auto iterator = ids_.find(name);
+		return iterator != ids_.end() ? iterator->second : symbols::none;
+	}
+
+	std::string_view SymbolTable::name(symbols::Id id) const {
+		return names_.at(id);
+	}
+
+	size_t SymbolTable::size(void) const {
+		return names_.size();
+	}
+} // namespace mmix
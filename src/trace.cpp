@@ -0,0 +1,101 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "trace.h"
+
+// Include C++ STL headers
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <iomanip>
+
+namespace mmix {
+	namespace trace {
+		std::atomic<bool> active{false};
+
+		namespace {
+			std::mutex 								mutex;				// Guards the events
+			std::vector<Event> 						events;				// Recorded spans
+			std::chrono::steady_clock::time_point 	origin;				// The time the tracing was enabled
+			std::atomic<uint32_t> 					threads{0};			// The number of seen threads
+
+			/**
+			 * Escape a string for JSON
+			 * @param value the string
+			 * @return the escaped string
+			 */
+			std::string escape(std::string_view value) {
+				std::string result;
+				for (auto character : value) {
+					if (character == '"' or character == '\\') result.push_back('\\');
+					if (static_cast<unsigned char>(character) < 0x20) character = ' ';
+					result.push_back(character);
+				}
+				return result;
+			}
+		} // namespace
+
+		void enable(void) {
+			origin = std::chrono::steady_clock::now();
+			active.store(true);
+		}
+
+		void disable(void) {
+			active.store(false);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			events.clear();
+		}
+
+		double now(void) {
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+		}
+
+		uint32_t thread(void) {
+			thread_local uint32_t id = threads.fetch_add(1);
+			return id;
+		}
+
+		void record(Event event) {
+			std::lock_guard<std::mutex> lock(mutex);
+			events.push_back(std::move(event));
+		}
+
+		void write(std::ostream& stream) {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			stream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+			stream << std::fixed << std::setprecision(3);
+			for (size_t index = 0; index < events.size(); ++index) {
+				const auto& event = events[index];
+
+				stream << "  {\"ph\": \"X\", \"pid\": 1"
+					<< ", \"tid\": " << event.thread
+					<< ", \"ts\": " << event.start
+					<< ", \"dur\": " << event.duration
+					<< ", \"cat\": \"" << escape(event.category) << "\""
+					<< ", \"name\": \"" << escape(event.name) << "\"";
+				if (not event.detail.empty()) 
+					stream << ", \"args\": {\"detail\": \"" << escape(event.detail) << "\"}";
+				stream << "}" << (index + 1 == events.size() ? "" : ",") << std::endl;
+			}
+			stream << "]}" << std::endl;
+		}
+	} // namespace trace
+} // namespace mmix
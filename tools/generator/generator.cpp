@@ -0,0 +1,177 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "generator.h"
+
+// Include C++ STL headers
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+
+// Include project headers
+#include "mnemonics.h"
+
+using mmix::generator::File;
+using mmix::generator::Files;
+using mmix::generator::Options;
+
+namespace mmix {
+	Generator::Generator(const Options& options) :
+		options_{options},
+		random_{options.seed},
+		kinds_{{static_cast<double>(options.mix.mnemonics), static_cast<double>(options.mix.labels), 
+			static_cast<double>(options.mix.data), static_cast<double>(options.mix.macros), 
+			static_cast<double>(options.mix.branches), static_cast<double>(options.mix.blocks)}} {
+		// Split the lines between the files
+		uint64_t share = options_.lines / (options_.files + 1);
+		for (uint32_t index = 0; index <= options_.files; ++index) {
+			auto lines = index == 0 ? options_.lines - share * options_.files : share;
+			files_.push_back(generate(index, lines));
+		}
+	}
+
+	uint64_t Generator::number(uint64_t bound) {
+		return bound ? random_() % bound : 0;
+	}
+
+	void Generator::mnemonic(std::stringstream& stream, const std::string& operand) {
+		const auto& entry = compiler::mnemonics[number(std::size(compiler::mnemonics))];
+
+		stream << entry.first << " $" << number(256) << ",$" << number(256) << ",";
+		if (operand.empty()) stream << number(256);
+		else stream << operand;
+		stream << std::endl;
+	}
+
+	uint64_t Generator::lines(std::stringstream& stream, Kind kind, bool main) {
+		switch (kind) {
+			// A constant and its use
+			case Kind::LABEL: {
+				auto label = "s" + std::to_string(labels_++);
+				stream << label << " IS " << number(256) << std::endl;
+				mnemonic(stream, label);
+				return 2;
+			}
+
+			// Data and its use
+			case Kind::DATA: {
+				auto label = "d" + std::to_string(labels_++);
+				stream << label << (number(2) ? " BYTE " : " OCTA ") << number(256) << std::endl;
+				mnemonic(stream, label);
+				return 2;
+			}
+
+			// Macros are visible only in the file they are defined in
+			case Kind::MACRO: 
+				if (not main or options_.macros == 0) break;
+				stream << "USEMACRO M" << number(options_.macros) << "," 
+					<< number(256) << "," << number(256) << std::endl;
+				return 1;
+
+			// A conditional block (constants are defined in the main file too)
+			case Kind::BRANCH: {
+				if (not main or options_.flags == 0) break;
+
+				auto flag = "F" + std::to_string(number(options_.flags));
+				if (number(2)) stream << "IFDEF " << flag << std::endl;
+				else stream << "IF " << flag << "==1" << std::endl;
+
+				uint64_t size = 1 + number(3);
+				for (uint64_t index = 0; index < size; ++index) mnemonic(stream);
+				stream << "ENDIF" << std::endl;
+				return size + 2;
+			}
+
+			// A block which is moved to its use
+			case Kind::BLOCK: {
+				auto block = "b" + std::to_string(blocks_++);
+				stream << "BLOCK " << block << std::endl;
+
+				uint64_t size = 1 + number(4);
+				for (uint64_t index = 0; index < size; ++index) mnemonic(stream);
+				stream << "ENDBLOCK " << block << std::endl;
+
+				mnemonic(stream);
+				stream << "USE " << block << std::endl;
+				return size + 4;
+			}
+
+			default:
+				break;
+		}
+
+		mnemonic(stream);
+		return 1;
+	}
+
+	std::string Generator::path(uint32_t index) const {
+		auto name = index == 0 ? std::string("main.mms") : "lib" + std::to_string(index) + ".mms";
+		return (std::filesystem::path(options_.directory) / name).string();
+	}
+
+	File Generator::generate(uint32_t index, uint64_t count) {
+		std::stringstream 	stream;
+		uint64_t 			written = 0;
+		bool 				main 	= index == 0;
+
+		// The main file starts the program and defines macros and constants
+		if (main) {
+			stream << "Main ADD $1,$2,$3" << std::endl;
+			for (uint32_t macro = 0; macro < options_.macros; ++macro) {
+				const auto& entry = compiler::mnemonics[number(std::size(compiler::mnemonics))];
+				stream << "M" << macro << " MACRO p,q " << entry.first << " $" << number(256) 
+					<< ",&p,&q" << std::endl;
+			}
+			for (uint32_t flag = 0; flag < options_.flags; ++flag) 
+				stream << "F" << flag << " DEFINE " << number(2) << std::endl;
+			written += 1 + options_.macros + options_.flags;
+		}
+
+		// Include some of the next files (so the graph has no cycles)
+		for (uint32_t next = index + 1, included = 0; 
+			next <= options_.files and included < options_.fanout; ++next) {
+			if (next != index + 1 and number(2)) continue;
+
+			stream << "INCLUDE " << path(next) << std::endl;
+			++included;
+			++written;
+		}
+
+		while (written < count) written += lines(stream, static_cast<Kind>(kinds_(random_)), main);
+
+		return File(path(index), stream.str());
+	}
+
+	const Files& Generator::get(void) const {
+		return files_;
+	}
+
+	std::vector<std::string> Generator::write(void) const {
+		std::vector<std::string> paths;
+
+		std::filesystem::create_directories(options_.directory);
+		for (const auto& [path, content] : files_) {
+			std::ofstream stream(path);
+			stream << content;
+			paths.push_back(path);
+		}
+
+		return paths;
+	}
+} // namespace mmix
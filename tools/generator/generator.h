@@ -0,0 +1,148 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+// Include C++ STL headers
+#include <vector>
+#include <string>
+#include <sstream>
+#include <random>
+#include <utility>
+#include <cstdint>
+
+namespace mmix {
+	namespace generator {
+		/**
+		 * Relative weights of the kinds of generated lines
+		 */
+		struct Mix {
+			uint32_t mnemonics{60};		// Instructions from the mnemonic table
+			uint32_t labels{10};		// "IS" labels and their uses
+			uint32_t data{10};			// "BYTE"/"OCTA" data and its uses
+			uint32_t macros{10};		// "USEMACRO" expansions
+			uint32_t branches{5};		// "IFDEF"/"IF" blocks
+			uint32_t blocks{5};			// "BLOCK"/"USE" regions
+		};
+
+		/**
+		 * Parameters of a generated program
+		 */
+		struct Options {
+			uint64_t 	lines{1000};	// The number of lines of all the files
+			uint32_t 	files{0};		// The number of included files
+			uint32_t 	fanout{2};		// The maximum number of includes in a file
+			uint32_t 	macros{4};		// The number of macro definitions
+			uint32_t 	flags{4};		// The number of "DEFINE" constants
+			uint64_t 	seed{1};		// The seed of the random generator
+			std::string directory{"."};	// The directory of the files (it's a part of the "INCLUDE" names)
+			Mix 		mix;			// Weights of the kinds of lines
+		};
+
+		using File 	= std::pair<std::string, std::string>;		// The path and the content of a file
+		using Files = std::vector<File>;
+	} // namespace generator
+
+	/**
+	 * Generator of synthetic MMIX programs. The main file
+	 * defines macros and constants, the other files form
+	 * an include graph (a file includes only the files
+	 * with greater numbers). Every label is defined before
+	 * its use, the same seed gives the same program.
+	 */
+	class Generator {
+	protected:
+		/**
+		 * Kinds of generated lines (in the order of the weights)
+		 */
+		enum Kind {
+			MNEMONIC = 0,
+			LABEL,
+			DATA,
+			MACRO,
+			BRANCH,
+			BLOCK
+		};
+
+		generator::Options 		options_;			// Parameters of the program
+		generator::Files 		files_;				// Generated files
+		std::mt19937_64 		random_;			// Source of the random numbers
+		std::discrete_distribution<int> kinds_;		// Distribution of the kinds of lines
+		uint64_t 				labels_{0};			// The number of defined labels
+		uint64_t 				blocks_{0};			// The number of defined blocks
+
+	protected:
+		/**
+		 * Get a random number
+		 * @param bound the upper bound (excluded)
+		 * @return the number
+		 */
+		uint64_t number(uint64_t bound);
+
+		/**
+		 * Write a random mnemonic with operands
+		 * @param stream the stream to write to
+		 * @param operand the last operand (random if empty)
+		 */
+		void mnemonic(std::stringstream& stream, const std::string& operand = "");
+
+		/**
+		 * Write the lines of the kind
+		 * @param stream the stream to write to
+		 * @param kind the kind of the lines
+		 * @param main true if the file is the main one (macros are defined only there)
+		 * @return the number of written lines
+		 */
+		uint64_t lines(std::stringstream& stream, Kind kind, bool main);
+
+		/**
+		 * Get the path of a file
+		 * @param index the number of the file (0 is the main file)
+		 * @return the path
+		 */
+		std::string path(uint32_t index) const;
+
+		/**
+		 * Generate a file
+		 * @param index the number of the file (0 is the main file)
+		 * @param lines the number of lines
+		 * @return the file
+		 */
+		generator::File generate(uint32_t index, uint64_t lines);
+
+	public:
+		/**
+		 * Constructor. The program is generated at once.
+		 * @param options parameters of the program
+		 */
+		explicit Generator(const generator::Options& options);
+
+		/**
+		 * Get the generated files (the main one is the first)
+		 * @return the files
+		 */
+		const generator::Files& get(void) const;
+
+		/**
+		 * Write the files (the directory is created if needed)
+		 * @return the paths of the files
+		 */
+		std::vector<std::string> write(void) const;
+	};
+} // namespace mmix
@@ -0,0 +1,79 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// Include Boost headers
+#include <boost/program_options.hpp>
+
+// Include C++ STL headers
+#include <string>
+#include <iostream>
+
+// Include project headers
+#include "generator.h"
+
+int main(int argc, char** argv) {
+	mmix::generator::Options options;
+
+	// Add options
+	boost::program_options::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "produce help message")
+		("lines,n", boost::program_options::value<uint64_t>(&options.lines)->default_value(options.lines), 
+			"Number of lines of the program")
+		("files", boost::program_options::value<uint32_t>(&options.files)->default_value(options.files), 
+			"Number of included files")
+		("fanout", boost::program_options::value<uint32_t>(&options.fanout)->default_value(options.fanout), 
+			"Maximum number of includes in a file")
+		("macros", boost::program_options::value<uint32_t>(&options.macros)->default_value(options.macros), 
+			"Number of macro definitions")
+		("defines", boost::program_options::value<uint32_t>(&options.flags)->default_value(options.flags), 
+			"Number of DEFINE constants")
+		("seed", boost::program_options::value<uint64_t>(&options.seed)->default_value(options.seed), 
+			"Seed of the random generator")
+		("directory,d", boost::program_options::value<std::string>(&options.directory)->
+			default_value(options.directory), "Directory to write the files to")
+		("mnemonics", boost::program_options::value<uint32_t>(&options.mix.mnemonics)->
+			default_value(options.mix.mnemonics), "Weight of plain instructions")
+		("labels", boost::program_options::value<uint32_t>(&options.mix.labels)->
+			default_value(options.mix.labels), "Weight of IS labels")
+		("data", boost::program_options::value<uint32_t>(&options.mix.data)->
+			default_value(options.mix.data), "Weight of BYTE/OCTA data")
+		("expansions", boost::program_options::value<uint32_t>(&options.mix.macros)->
+			default_value(options.mix.macros), "Weight of USEMACRO expansions")
+		("branches", boost::program_options::value<uint32_t>(&options.mix.branches)->
+			default_value(options.mix.branches), "Weight of IFDEF/IF blocks")
+		("blocks", boost::program_options::value<uint32_t>(&options.mix.blocks)->
+			default_value(options.mix.blocks), "Weight of BLOCK/USE regions");
+
+	// Parse arguments
+	boost::program_options::variables_map vm;
+	boost::program_options::store(boost::program_options::command_line_parser(argc, argv).
+		options(desc).run(), vm);
+	boost::program_options::notify(vm);
+
+	if (vm.count("help")) {
+		std::cout << "Usage: generator [options]" << std::endl << desc;
+		return 0;
+	}
+
+	// Print the paths, so they can be passed to the assembler (the main file is the first)
+	for (const auto& path : mmix::Generator(options).write()) std::cout << path << std::endl;
+
+	return 0;
+}